@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+
+#include "benchmarkUtils.h"
+#include "syntheticConfig.h"
+#include "configPlugin.h"
+#include "configSnapshot.h"
+
+using namespace systemspn;
+
+static void BM_ImportExchangedData(benchmark::State& state)
+{
+    int points = static_cast<int>(state.range(0));
+    std::string exchangedData = SyntheticConfig::buildExchangedData(points / 2, points - points / 2);
+    ConfigPlugin configPlugin;
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        configPlugin.importExchangedData(exchangedData);
+        benchmark::DoNotOptimize(configPlugin.getDataSystem());
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * points);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(exchangedData.size()));
+}
+BENCHMARK(BM_ImportExchangedData)->Arg(10)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ImportExchangedDataSnapshot(benchmark::State& state)
+{
+    int points = static_cast<int>(state.range(0));
+    std::string exchangedData = SyntheticConfig::buildExchangedData(points / 2, points - points / 2);
+    char directory[] = "/tmp/systemspn_benchXXXXXX";
+    if (mkdtemp(directory) == nullptr) {
+        state.SkipWithError("Cannot create the snapshot directory");
+        return;
+    }
+    ConfigPlugin configPlugin;
+    configPlugin.setSnapshotDirectory(directory);
+    // First import writes the snapshot, next ones restore it
+    configPlugin.importExchangedData(exchangedData);
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        configPlugin.importExchangedData(exchangedData);
+        benchmark::DoNotOptimize(configPlugin.getDataSystem());
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * points);
+    state.counters["from_snapshot"] = configPlugin.isLoadedFromSnapshot() ? 1 : 0;
+    std::remove(ConfigSnapshot::getPath(directory, "", ConfigSnapshot::hash(exchangedData)).c_str());
+    std::remove(directory);
+}
+BENCHMARK(BM_ImportExchangedDataSnapshot)->Arg(10)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_HasDataForType(benchmark::State& state)
+{
+    int points = static_cast<int>(state.range(0));
+    ConfigPlugin configPlugin;
+    configPlugin.importExchangedData(SyntheticConfig::buildExchangedData(0, points));
+    // Look up the last point, worst case of a linear search
+    const std::string pivotId = "M_" + std::to_string(points - 1);
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(configPlugin.hasDataForType("prt.inf", pivotId));
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_HasDataForType)->Arg(10)->Arg(1000)->Arg(100000);
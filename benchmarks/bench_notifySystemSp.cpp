@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include <config_category.h>
+#include <regex>
+
+#include "benchmarkUtils.h"
+#include "syntheticConfig.h"
+#include "notifySystemSp.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+namespace {
+    void countingIngest(void *data, void */*readingPtr*/) {
+        (*static_cast<uint64_t*>(data))++;
+    }
+
+    // Plugin with 'prt.inf' status points only, so that no cycle thread interferes with the measures
+    class BenchmarkPlugin {
+    public:
+        explicit BenchmarkPlugin(int prtInfPoints) {
+            ConfigCategory config("benchmark", SyntheticConfig::buildPluginConfig(
+                                               SyntheticConfig::buildExchangedData(0, prtInfPoints)));
+            plugin.reconfigure(config);
+            plugin.registerIngest(countingIngest, &ingested);
+        }
+        NotifySystemSp plugin;
+        uint64_t       ingested = 0;
+    };
+}
+
+static void BM_FillTemplate(benchmark::State& state)
+{
+    BenchmarkPlugin benchmarkPlugin(1);
+    const MessageTemplate messageTemplate(benchmarkPlugin.plugin.getMessageTemplate("acces"));
+    long timestampMs = 1700000000000;
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(benchmarkPlugin.plugin.fillTemplate(messageTemplate, "M_2367_3_15_4", "SpsTyp",
+                                                                     UtilityPivot::fromTimestamp(timestampMs++)));
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_FillTemplate);
+
+// Previous implementation of fillTemplate, one std::regex_replace per placeholder
+static void BM_FillTemplateRegex(benchmark::State& state)
+{
+    BenchmarkPlugin benchmarkPlugin(1);
+    const std::string messageTemplate = benchmarkPlugin.plugin.getMessageTemplate("acces");
+    long timestampMs = 1700000000000;
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto timePair = UtilityPivot::fromTimestamp(timestampMs++);
+        std::string message = std::regex_replace(messageTemplate, std::regex("<pivot_id>"), "M_2367_3_15_4");
+        message = std::regex_replace(message, std::regex("<pivot_type>"), "SpsTyp");
+        message = std::regex_replace(message, std::regex("<timestamp_sec>"), std::to_string(timePair.first));
+        message = std::regex_replace(message, std::regex("<timestamp_sub_sec>"), std::to_string(timePair.second));
+        message = std::regex_replace(message, std::regex("<value>"), "1");
+        benchmark::DoNotOptimize(message);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_FillTemplateRegex);
+
+static void BM_SendReading(benchmark::State& state)
+{
+    BenchmarkPlugin benchmarkPlugin(1);
+    const std::string jsonReading = benchmarkPlugin.plugin.fillTemplate(
+        benchmarkPlugin.plugin.getMessageTemplate("acces"), "M_2367_3_15_4", "SpsTyp", 1700000000000);
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmarkPlugin.plugin.sendReading("TS-1", jsonReading);
+    }
+    allocations.report(state);
+    state.counters["ingested"] = static_cast<double>(benchmarkPlugin.ingested);
+}
+BENCHMARK(BM_SendReading);
+
+static void BM_Notify(benchmark::State& state, const char *triggerReason, int prtInfPoints)
+{
+    BenchmarkPlugin benchmarkPlugin(prtInfPoints);
+    const std::string reason(triggerReason);
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(benchmarkPlugin.plugin.notify("notification", reason, "message"));
+    }
+    allocations.report(state);
+    state.counters["readings"] = benchmark::Counter(static_cast<double>(benchmarkPlugin.ingested),
+                                                    benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_CAPTURE(BM_Notify, gi_finished_1, R"({"asset":"gi_status","reason":"finished"})", 1);
+BENCHMARK_CAPTURE(BM_Notify, gi_finished_100, R"({"asset":"gi_status","reason":"finished"})", 100);
+BENCHMARK_CAPTURE(BM_Notify, connx_status, R"({"asset":"connx_status","reason":"connected"})", 1);
+BENCHMARK_CAPTURE(BM_Notify, unhandled_asset, R"({"asset":"other_asset","reason":"finished"})", 1);
+BENCHMARK_CAPTURE(BM_Notify, invalid_json, R"({"asset":"gi_status",)", 1);
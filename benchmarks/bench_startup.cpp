@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+#include <config_category.h>
+#include <plugin_api.h>
+#include <chrono>
+#include <thread>
+
+#include "syntheticConfig.h"
+#include "notifySystemSp.h"
+
+using namespace systemspn;
+
+extern "C" {
+	PLUGIN_HANDLE plugin_init(ConfigCategory *config);
+    void plugin_registerIngest(PLUGIN_HANDLE *handle, void *func, void *data);
+    void plugin_shutdown(PLUGIN_HANDLE *handle);
+};
+
+namespace {
+    using BenchClock = std::chrono::steady_clock;
+
+    void discardingIngest(void */*data*/, void */*readingPtr*/) {}
+
+    double elapsedSec(const BenchClock::time_point& start, const BenchClock::time_point& end) {
+        return std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+    }
+
+    // Wait until the plugin emitted at least the given number of cyclic readings
+    BenchClock::time_point waitForReadings(const NotifySystemSp& plugin, uint64_t readings) {
+        while (plugin.getMetrics().counter(PerfMetrics::Counter::ReadingsAcces) < readings) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return BenchClock::now();
+    }
+}
+
+/**
+ * Time from plugin_init to the first emitted reading (iteration time), with the time spent
+ * in plugin_init itself and the time until every cyclic status point was emitted once
+ */
+static void BM_StartupToFirstReading(benchmark::State& state, bool backgroundInit)
+{
+    const int cyclicPoints = static_cast<int>(state.range(0));
+    const int prtInfPoints = static_cast<int>(state.range(1));
+    const std::string pluginConfig = SyntheticConfig::buildPluginConfig(
+        SyntheticConfig::buildExchangedData(cyclicPoints, prtInfPoints), true, backgroundInit);
+    double initSec = 0;
+    double allReadingsSec = 0;
+    for (auto _ : state) {
+        ConfigCategory config("benchmark", pluginConfig);
+        auto start = BenchClock::now();
+        PLUGIN_HANDLE handle = plugin_init(&config);
+        auto initReturned = BenchClock::now();
+        // As done by the notification service, readings emitted before this call are counted but dropped
+        plugin_registerIngest(reinterpret_cast<PLUGIN_HANDLE*>(handle), (void*)discardingIngest, nullptr);
+        auto plugin = static_cast<NotifySystemSp *>(handle);
+        auto firstReading = waitForReadings(*plugin, 1);
+        auto allReadings = waitForReadings(*plugin, static_cast<uint64_t>(cyclicPoints));
+        state.SetIterationTime(elapsedSec(start, firstReading));
+        initSec += elapsedSec(start, initReturned);
+        allReadingsSec += elapsedSec(start, allReadings);
+        plugin_shutdown(reinterpret_cast<PLUGIN_HANDLE*>(handle));
+    }
+    state.counters["init_ms"] = benchmark::Counter(initSec * 1000, benchmark::Counter::kAvgIterations);
+    state.counters["all_readings_ms"] = benchmark::Counter(allReadingsSec * 1000, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_CAPTURE(BM_StartupToFirstReading, sync, false)
+    ->Args({10, 10})->Args({1000, 1000})->Args({100, 100000})
+    ->UseManualTime()->Unit(benchmark::kMillisecond)->Iterations(5);
+BENCHMARK_CAPTURE(BM_StartupToFirstReading, background, true)
+    ->Args({10, 10})->Args({1000, 1000})->Args({100, 100000})
+    ->UseManualTime()->Unit(benchmark::kMillisecond)->Iterations(5);
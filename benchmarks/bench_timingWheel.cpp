@@ -0,0 +1,181 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "benchmarkUtils.h"
+#include "timingWheel.h"
+
+using namespace systemspn;
+
+namespace {
+    constexpr long StartMs = 1700000000000;
+
+    // Binary heap of the deadlines, ordered by time then by point index, as a baseline of the timing wheel
+    class DeadlineHeap {
+    public:
+        struct Entry {
+            long        deadlineMs;
+            std::size_t id;
+            bool operator>(const Entry& other) const {
+                return deadlineMs != other.deadlineMs ? deadlineMs > other.deadlineMs : id > other.id;
+            }
+        };
+
+        void schedule(std::size_t id, long deadlineMs) {
+            m_heap.push_back({deadlineMs, id});
+            std::push_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+        }
+
+        // A heap has no handle on its entries, removing one requires a rebuild
+        void cancel(std::size_t id) {
+            auto it = std::find_if(m_heap.begin(), m_heap.end(), [id](const Entry& entry) { return entry.id == id; });
+            if (it != m_heap.end()) {
+                *it = m_heap.back();
+                m_heap.pop_back();
+                std::make_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+            }
+        }
+
+        void advance(long nowMs, std::vector<Entry>& expired) {
+            while (!m_heap.empty() && m_heap.front().deadlineMs <= nowMs) {
+                std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+                expired.push_back(m_heap.back());
+                m_heap.pop_back();
+            }
+        }
+
+        void reserve(std::size_t size) { m_heap.reserve(size); }
+
+    private:
+        std::vector<Entry> m_heap;
+    };
+
+    // Second to hour scale cycles, first deadlines spread over the first minute
+    struct SyntheticPoints {
+        explicit SyntheticPoints(std::size_t count) {
+            std::mt19937 random(42);
+            std::uniform_int_distribution<long> cycleDistribution(1, 3600);
+            std::uniform_int_distribution<long> phaseDistribution(0, 59999);
+            for (std::size_t i = 0; i < count; i++) {
+                cyclesMs.push_back(1000 * cycleDistribution(random));
+                firstDeadlinesMs.push_back(StartMs + phaseDistribution(random));
+            }
+        }
+        std::vector<long> cyclesMs;
+        std::vector<long> firstDeadlinesMs;
+    };
+
+    // Advances by 10 ms per iteration, every expired point is scheduled again one cycle later
+    template<class Scheduler, class Expired>
+    void runCycles(benchmark::State& state, Scheduler& scheduler, const SyntheticPoints& points) {
+        std::vector<Expired> expired;
+        long nowMs = StartMs;
+        int64_t expirations = 0;
+        BenchmarkUtils::AllocationCounter allocations;
+        for (auto _ : state) {
+            nowMs += 10;
+            expired.clear();
+            scheduler.advance(nowMs, expired);
+            for (const auto& entry : expired) {
+                scheduler.schedule(entry.id, entry.deadlineMs + points.cyclesMs[entry.id]);
+            }
+            expirations += static_cast<int64_t>(expired.size());
+        }
+        allocations.report(state);
+        state.counters["expirations"] = benchmark::Counter(static_cast<double>(expirations),
+                                                           benchmark::Counter::kAvgIterations);
+    }
+}
+
+static void BM_HeapSchedule(benchmark::State& state)
+{
+    SyntheticPoints points(static_cast<std::size_t>(state.range(0)));
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        DeadlineHeap heap;
+        heap.reserve(points.cyclesMs.size());
+        for (std::size_t i = 0; i < points.cyclesMs.size(); i++) {
+            heap.schedule(i, points.firstDeadlinesMs[i]);
+        }
+        benchmark::DoNotOptimize(heap);
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HeapSchedule)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_WheelSchedule(benchmark::State& state)
+{
+    SyntheticPoints points(static_cast<std::size_t>(state.range(0)));
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        TimingWheel wheel;
+        wheel.reset(StartMs);
+        for (std::size_t i = 0; i < points.cyclesMs.size(); i++) {
+            wheel.schedule(i, points.firstDeadlinesMs[i]);
+        }
+        benchmark::DoNotOptimize(wheel);
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WheelSchedule)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_HeapCycles(benchmark::State& state)
+{
+    SyntheticPoints points(static_cast<std::size_t>(state.range(0)));
+    DeadlineHeap heap;
+    for (std::size_t i = 0; i < points.cyclesMs.size(); i++) {
+        heap.schedule(i, points.firstDeadlinesMs[i]);
+    }
+    runCycles<DeadlineHeap, DeadlineHeap::Entry>(state, heap, points);
+}
+BENCHMARK(BM_HeapCycles)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void BM_WheelCycles(benchmark::State& state)
+{
+    SyntheticPoints points(static_cast<std::size_t>(state.range(0)));
+    TimingWheel wheel;
+    wheel.reset(StartMs);
+    for (std::size_t i = 0; i < points.cyclesMs.size(); i++) {
+        wheel.schedule(i, points.firstDeadlinesMs[i]);
+    }
+    runCycles<TimingWheel, TimingWheel::Expired>(state, wheel, points);
+}
+BENCHMARK(BM_WheelCycles)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+// Removal then addition of one point, as done for each changed point on reconfigure
+static void BM_HeapReplacePoint(benchmark::State& state)
+{
+    SyntheticPoints points(static_cast<std::size_t>(state.range(0)));
+    DeadlineHeap heap;
+    for (std::size_t i = 0; i < points.cyclesMs.size(); i++) {
+        heap.schedule(i, points.firstDeadlinesMs[i]);
+    }
+    std::size_t id = 0;
+    for (auto _ : state) {
+        heap.cancel(id);
+        heap.schedule(id, points.firstDeadlinesMs[id] + points.cyclesMs[id]);
+        id = (id + 7919) % points.cyclesMs.size();
+    }
+}
+BENCHMARK(BM_HeapReplacePoint)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void BM_WheelReplacePoint(benchmark::State& state)
+{
+    SyntheticPoints points(static_cast<std::size_t>(state.range(0)));
+    TimingWheel wheel;
+    wheel.reset(StartMs);
+    for (std::size_t i = 0; i < points.cyclesMs.size(); i++) {
+        wheel.schedule(i, points.firstDeadlinesMs[i]);
+    }
+    std::size_t id = 0;
+    for (auto _ : state) {
+        wheel.cancel(id);
+        wheel.schedule(id, points.firstDeadlinesMs[id] + points.cyclesMs[id]);
+        id = (id + 7919) % points.cyclesMs.size();
+    }
+}
+BENCHMARK(BM_WheelReplacePoint)->Arg(1000)->Arg(100000)->Arg(1000000);
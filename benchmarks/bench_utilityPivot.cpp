@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "benchmarkUtils.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+static void BM_FromTimestamp(benchmark::State& state)
+{
+    long timestampMs = UtilityPivot::getCurrentTimestampMs();
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(UtilityPivot::fromTimestamp(timestampMs++));
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_FromTimestamp);
+
+static void BM_ToTimestamp(benchmark::State& state)
+{
+    auto timePair = UtilityPivot::fromTimestamp(UtilityPivot::getCurrentTimestampMs());
+    long fractionOfSecond = timePair.second;
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(UtilityPivot::toTimestamp(timePair.first, fractionOfSecond));
+        fractionOfSecond = (fractionOfSecond + 16777) & 0xFFFFFF;
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_ToTimestamp);
+
+// Seconds then fractions of the timestamps, formatted as in a reading template
+static void BM_IntegerToString(benchmark::State& state)
+{
+    long timestampMs = UtilityPivot::getCurrentTimestampMs();
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto timePair = UtilityPivot::fromTimestamp(timestampMs++);
+        benchmark::DoNotOptimize(std::to_string(timePair.first));
+        benchmark::DoNotOptimize(std::to_string(timePair.second));
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_IntegerToString);
+
+static void BM_FormatInteger(benchmark::State& state)
+{
+    long timestampMs = UtilityPivot::getCurrentTimestampMs();
+    char buffer[2 * UtilityPivot::IntegerBufferSize];
+    BenchmarkUtils::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto timePair = UtilityPivot::fromTimestamp(timestampMs++);
+        char *end = UtilityPivot::formatInteger(timePair.first, buffer);
+        end = UtilityPivot::formatInteger(timePair.second, end);
+        benchmark::DoNotOptimize(end);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_FormatInteger);
@@ -0,0 +1,67 @@
+/*
+ * Helpers shared by the plugin microbenchmarks
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "benchmarkUtils.h"
+
+namespace {
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+}
+
+// Global allocation hooks, every allocation of the benchmarked code goes through them
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+/**
+ * Get the number of heap allocations done since startup
+ *
+ * @return Number of calls to operator new
+*/
+uint64_t BenchmarkUtils::getAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Get the number of bytes allocated on the heap since startup
+ *
+ * @return Sum of the sizes requested to operator new
+*/
+uint64_t BenchmarkUtils::getAllocatedBytes() {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
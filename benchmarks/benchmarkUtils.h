@@ -0,0 +1,38 @@
+#ifndef BENCHMARKS_BENCHMARK_UTILS_H_
+#define BENCHMARKS_BENCHMARK_UTILS_H_
+
+/*
+ * Helpers shared by the plugin microbenchmarks
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cstdint>
+#include <string>
+#include <benchmark/benchmark.h>
+
+namespace BenchmarkUtils {
+    uint64_t    getAllocationCount();
+    uint64_t    getAllocatedBytes();
+
+    /**
+     * Counts heap allocations done between its construction and the call to report()
+     */
+    class AllocationCounter {
+    public:
+        AllocationCounter(): m_count(getAllocationCount()), m_bytes(getAllocatedBytes()) {}
+        void report(benchmark::State& state) const {
+            state.counters["allocs"] = benchmark::Counter(static_cast<double>(getAllocationCount() - m_count),
+                                                          benchmark::Counter::kAvgIterations);
+            state.counters["alloc_bytes"] = benchmark::Counter(static_cast<double>(getAllocatedBytes() - m_bytes),
+                                                               benchmark::Counter::kAvgIterations);
+        }
+    private:
+        uint64_t m_count;
+        uint64_t m_bytes;
+    };
+};
+
+#endif  // BENCHMARKS_BENCHMARK_UTILS_H_
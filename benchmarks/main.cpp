@@ -0,0 +1,15 @@
+#include <benchmark/benchmark.h>
+#include <logger.h>
+
+int main(int argc, char **argv) {
+    // Logs would dominate the measures
+    Logger::getLogger()->setMinLevel("error");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * Synthetic plugin configurations for benchmarks and load tools
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include "syntheticConfig.h"
+
+/**
+ * Generate an exchanged_data configuration with synthetic status points
+ *
+ * @param cyclicPoints : Number of cyclic ('acces') status points
+ * @param prtInfPoints : Number of 'prt.inf' status points
+ * @param cycleSec : Emission cycle of the cyclic status points
+ * @param cycleMs : Emission cycle in milliseconds (ts_syst_cycle_ms), used instead of cycleSec if positive
+ * @return Json exchanged_data configuration
+*/
+std::string SyntheticConfig::buildExchangedData(int cyclicPoints, int prtInfPoints, int cycleSec /*= 30*/,
+                                                long cycleMs /*= 0*/) {
+    std::string json = "{\"exchanged_data\":{\"datapoints\":[";
+    for (int i = 0; i < cyclicPoints + prtInfPoints; i++) {
+        bool cyclic = i < cyclicPoints;
+        std::string index = std::to_string(i);
+        if (i > 0) {
+            json += ",";
+        }
+        json += "{\"label\":\"TS-" + index + "\",\"pivot_id\":\"M_" + index + "\",\"pivot_type\":\"" +
+                (i % 2 ? "DpsTyp" : "SpsTyp") + "\",";
+        if (cyclic) {
+            json += "\"pivot_subtypes\":[\"acces\"],";
+            json += cycleMs > 0 ? "\"ts_syst_cycle_ms\":" + std::to_string(cycleMs) + "," :
+                                  "\"ts_syst_cycle\":" + std::to_string(cycleSec) + ",";
+        }
+        else {
+            json += "\"pivot_subtypes\":[\"prt.inf\",\"transient\"],";
+        }
+        json += "\"protocols\":[{\"name\":\"IEC104\",\"typeid\":\"M_SP_TB_1\",\"address\":\"" + index + "\"}]}";
+    }
+    json += "]}}";
+    return json;
+}
+
+/**
+ * Generate a plugin configuration, as given to plugin_reconfigure()
+ *
+ * @param exchangedData : Json exchanged_data configuration
+ * @param enabled : Value of the enable item
+ * @param backgroundInit : Value of the background_init item
+ * @return Json plugin configuration
+*/
+std::string SyntheticConfig::buildPluginConfig(const std::string& exchangedData, bool enabled /*= true*/,
+                                               bool backgroundInit /*= false*/) {
+    return std::string("{\"enable\":{\"value\":\"") + (enabled ? "true" : "false") +
+           "\"},\"background_init\":{\"value\":\"" + (backgroundInit ? "true" : "false") +
+           "\"},\"exchanged_data\":{\"value\":" + exchangedData + "}}";
+}
@@ -0,0 +1,19 @@
+#ifndef BENCHMARKS_SYNTHETIC_CONFIG_H_
+#define BENCHMARKS_SYNTHETIC_CONFIG_H_
+
+/*
+ * Synthetic plugin configurations for benchmarks and load tools
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <string>
+
+namespace SyntheticConfig {
+    std::string buildExchangedData(int cyclicPoints, int prtInfPoints, int cycleSec = 30, long cycleMs = 0);
+    std::string buildPluginConfig(const std::string& exchangedData, bool enabled = true, bool backgroundInit = false);
+};
+
+#endif  // BENCHMARKS_SYNTHETIC_CONFIG_H_
@@ -0,0 +1,83 @@
+#ifndef INCLUDE_ASYNC_LOGGER_H_
+#define INCLUDE_ASYNC_LOGGER_H_
+
+/*
+ * Asynchronous logging backend
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace systemspn {
+
+namespace UtilityPivot {
+    enum class LogLevel;
+};
+
+/**
+ * Bounded lock-free ring buffer of formatted log messages.
+ * Emitting threads only copy their message in a free slot (or count it as dropped when the
+ * buffer is full), and a background thread forwards the messages to the Fledge logger.
+ * The logger is shared by all plugin instances of the process: each start() must be matched by
+ * a stop(), and the logger only stops when its last user stops it.
+ */
+class AsyncLogger {
+public:
+    static constexpr std::size_t MessageSize = 512;
+    static constexpr std::size_t DefaultCapacity = 1024;
+    static constexpr long DefaultFlushPeriodMs = 10;
+
+    static AsyncLogger& getInstance();
+
+    void start(std::size_t capacity = DefaultCapacity, long flushPeriodMs = DefaultFlushPeriodMs);
+    void stop();
+    bool isActive() const { return m_active.load(std::memory_order_relaxed); }
+    unsigned int getUsers() const;
+    bool push(UtilityPivot::LogLevel level, const char *message);
+
+    std::size_t getCapacity() const { return m_mask + 1; }
+    std::size_t getQueuedCount() const;
+    unsigned long getDroppedCount() const { return m_dropped; }
+    unsigned long getFlushedCount() const { return m_flushed; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        UtilityPivot::LogLevel   level;
+        char                     message[MessageSize];
+    };
+
+    AsyncLogger() = default;
+    ~AsyncLogger();
+    void m_run();
+    std::size_t m_flush();
+
+    std::unique_ptr<Slot[]>    m_slots;
+    std::size_t                m_mask = 0;
+    long                       m_flushPeriodMs = DefaultFlushPeriodMs;
+    std::atomic<bool>          m_active{false};
+    std::atomic<unsigned int>  m_producers{0};
+    std::atomic<std::size_t>   m_enqueuePos{0};
+    std::atomic<std::size_t>   m_dequeuePos{0};
+    std::atomic<unsigned long> m_dropped{0};
+    std::atomic<unsigned long> m_flushed{0};
+    std::thread                m_thread;
+    std::mutex                 m_wakeMutex;
+    std::condition_variable    m_wakeCond;
+    bool                       m_stopRequested = false;
+    mutable std::mutex         m_startStopMutex;
+    // Number of start() calls not matched by a stop() yet (protected by m_startStopMutex)
+    unsigned int               m_users = 0;
+};
+
+};
+
+#endif  // INCLUDE_ASYNC_LOGGER_H_
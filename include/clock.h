@@ -0,0 +1,103 @@
+#ifndef INCLUDE_CLOCK_H_
+#define INCLUDE_CLOCK_H_
+
+/*
+ * Time source of the emission scheduling
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace systemspn {
+
+/**
+ * Time source used by the emission threads to read the time and wait for their next deadline.
+ * Threads registered as participants are tracked by clocks that control the passing of time.
+ */
+class Clock {
+public:
+    virtual ~Clock() = default;
+
+    virtual long nowMs() = 0;
+    virtual void sleepForMs(long durationMs, const std::atomic<bool>& running) = 0;
+    virtual void notifyStop() {}
+    virtual void addParticipant() {}
+    virtual void removeParticipant() {}
+};
+
+/**
+ * Wall clock time, sleeps are real sleeps interrupted by notifyStop()
+ */
+class SystemClock : public Clock {
+public:
+    long nowMs() override;
+    void sleepForMs(long durationMs, const std::atomic<bool>& running) override;
+    void notifyStop() override;
+
+private:
+    std::mutex              m_mutex;
+    std::condition_variable m_stopCond;
+};
+
+/**
+ * Simulated time, only moving forward when advance() is called.
+ * advance() wakes the sleeping threads in the order of their deadlines, and waits for all participants
+ * to be sleeping again before moving the time further, so that hours of emissions run deterministically
+ * in a fraction of a second.
+ */
+class VirtualClock : public Clock {
+public:
+    static constexpr long DefaultSettleTimeoutMs = 10000;
+
+    explicit VirtualClock(long startMs = 0): m_nowMs(startMs) {}
+
+    long nowMs() override;
+    void sleepForMs(long durationMs, const std::atomic<bool>& running) override;
+    void notifyStop() override;
+    void addParticipant() override;
+    void removeParticipant() override;
+
+    bool advance(long durationMs, long settleTimeoutMs = DefaultSettleTimeoutMs);
+    bool waitForSleepers(long settleTimeoutMs = DefaultSettleTimeoutMs);
+    unsigned int getParticipants() const;
+    std::size_t getSleepers() const;
+
+private:
+    struct Sleeper {
+        bool woken = false;
+    };
+
+    bool m_waitForSleepers(std::unique_lock<std::mutex>& lock, long settleTimeoutMs);
+
+    mutable std::mutex               m_mutex;
+    std::condition_variable          m_wakeCond;
+    std::condition_variable          m_sleepCond;
+    long                             m_nowMs;
+    unsigned int                     m_participants = 0;
+    // Sleeping threads, indexed by the time at which they must be woken up
+    std::multimap<long, Sleeper*>    m_sleepers;
+};
+
+/**
+ * Registers the current thread as a participant of a clock for the lifetime of the object.
+ * The participant must already have been added by the thread that started the current thread.
+ */
+class ClockParticipant {
+public:
+    explicit ClockParticipant(Clock& clock): m_clock(clock) {}
+    ~ClockParticipant() { m_clock.removeParticipant(); }
+    ClockParticipant(const ClockParticipant&) = delete;
+    ClockParticipant& operator=(const ClockParticipant&) = delete;
+private:
+    Clock& m_clock;
+};
+
+};
+
+#endif  // INCLUDE_CLOCK_H_
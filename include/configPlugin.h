@@ -36,11 +36,14 @@ struct DataInfo {
 
 // Data info specific to cyclic Status Points
 struct CyclicDataInfo : public DataInfo {
-    int cycleSec = 0; // Status point emission cycle in seconds
+    int cycleSec = 0; // Status point emission cycle in seconds (rounded down for sub-second cycles)
+    long cycleMs = 0; // Status point emission cycle in milliseconds
 
+    // The cycle is always given in milliseconds (ts_syst_cycle is converted by the caller)
     CyclicDataInfo(const std::string& pivotIdInit, const std::string& pivotTypeInit,
-                   const std::string& assetNameInit, int cycleSecInit):
-        DataInfo{pivotIdInit, pivotTypeInit, assetNameInit}, cycleSec(cycleSecInit) {}
+                   const std::string& assetNameInit, long cycleMsInit):
+        DataInfo{pivotIdInit, pivotTypeInit, assetNameInit}, cycleSec(static_cast<int>(cycleMsInit / 1000)),
+        cycleMs(cycleMsInit) {}
     ~CyclicDataInfo() override = default; // Needed for dynamic_cast
 };
 
@@ -55,12 +58,25 @@ public:
     const std::map<std::string, std::vector<std::shared_ptr<DataInfo>>>& getDataSystem() const { return m_dataSystem; }
     const std::vector<std::string>& getDataTypes() const { return m_allDataTypes; }
 
+    void setSnapshotDirectory(const std::string& directory, const std::string& instanceName = "") {
+        m_snapshotDirectory = directory;
+        m_snapshotInstance = instanceName;
+    }
+    const std::string& getSnapshotDirectory() const { return m_snapshotDirectory; }
+    bool isLoadedFromSnapshot() const { return m_loadedFromSnapshot; }
+
 private:
     void m_reset();
     void m_importDatapoint(const rapidjson::Value& datapoint);
+    bool m_parseExchangedData(const std::string & exchangeConfig);
 
     std::vector<std::string> m_allDataTypes{"acces",  "prt.inf", "transient"};
     std::map<std::string, std::vector<std::shared_ptr<DataInfo>>> m_dataSystem;
+    // Snapshots of the imported configuration are disabled when the directory is empty
+    std::string m_snapshotDirectory;
+    // Name of the plugin instance, part of the snapshot file names
+    std::string m_snapshotInstance;
+    bool        m_loadedFromSnapshot = false;
 };
 
 };
@@ -0,0 +1,46 @@
+#ifndef INCLUDE_CONFIG_SNAPSHOT_H_
+#define INCLUDE_CONFIG_SNAPSHOT_H_
+
+/*
+ * Binary snapshot of the imported exchanged data
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "configPlugin.h"
+
+namespace systemspn {
+
+/*
+ * A snapshot stores the point tables built by ConfigPlugin::importExchangedData(),
+ * keyed by a hash of the exchanged_data JSON they were imported from, so that the
+ * same configuration can be restored on the next start without parsing the JSON.
+ * Each plugin instance only keeps the snapshot of its current configuration.
+ *
+ * Layout (native byte order, the file is only read back on the same host):
+ *   Header, then for each data type: name, point count, points
+ *   Point: flags (uint8, bit 0 cyclic, bit 1 transient warning), cycle in ms (int64),
+ *          pivot ID, pivot type, asset name
+ *   Strings are stored as a uint32 length followed by the characters
+ */
+namespace ConfigSnapshot {
+    using DataSystem = std::map<std::string, std::vector<std::shared_ptr<DataInfo>>>;
+
+    uint64_t    hash(const std::string& exchangedData);
+    std::string getPath(const std::string& directory, const std::string& instanceName, uint64_t hash);
+    int         removeOthers(const std::string& directory, const std::string& instanceName, const std::string& keptPath);
+    bool        load(const std::string& path, uint64_t hash, uint64_t sourceSize, DataSystem& dataSystem);
+    bool        write(const std::string& path, uint64_t hash, uint64_t sourceSize, const DataSystem& dataSystem);
+};
+
+};
+
+#endif  // INCLUDE_CONFIG_SNAPSHOT_H_
@@ -18,6 +18,7 @@ namespace ConstantsSystem {
     constexpr const char *JsonPivotId                 = "pivot_id";
     constexpr const char *JsonPivotSubtypes           = "pivot_subtypes";
     constexpr const char *JsonTsSystCycle             = "ts_syst_cycle";
+    constexpr const char *JsonTsSystCycleMs           = "ts_syst_cycle_ms";
 
     static const std::string JsonCdcSps     = "SpsTyp";
     static const std::string JsonCdcDps     = "DpsTyp";
@@ -0,0 +1,95 @@
+#ifndef INCLUDE_CYCLE_SCHEDULER_H_
+#define INCLUDE_CYCLE_SCHEDULER_H_
+
+/*
+ * Scheduler of the cyclic status point emissions
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "eventLoop.h"
+#include "timingWheel.h"
+
+namespace systemspn {
+
+/**
+ * Emits any number of cyclic status points from a single thread.
+ * Deadlines are kept in a hierarchical timing wheel, the thread sleeps until the earliest
+ * deadline and emits every point that is due when it wakes up.
+ * The next deadline of a point is its previous deadline plus its cycle, so that the
+ * cadence does not drift; deadlines missed by more than a cycle are skipped.
+ *
+ * With the system clock, the thread can wait on an EventLoop instead of sleeping: the earliest
+ * deadline is armed as an absolute kernel timer and wakeUp() interrupts the wait, so that no
+ * periodic wake-up is needed to notice a stop or the enabling of the emissions.
+ */
+class CycleScheduler {
+public:
+    // Without event loop: longest sleep of the scheduler thread and polling period while emissions are disabled
+    static constexpr long MaxSleepMs = 1000;
+    static constexpr long DisabledPollMs = 100;
+
+    struct Point {
+        long cycleMs;
+        long firstDeadlineMs;
+    };
+
+    /**
+     * Called by the scheduler thread for each due point.
+     * nowMs is the time sampled once per wake-up, identical for all the points due on it.
+     * deadlineValid is false for the first emission of a point and after emissions were disabled.
+     * Returning false removes the point from the schedule.
+     */
+    using EmitFunction = std::function<bool(std::size_t point, long deadlineMs, long nowMs, bool deadlineValid)>;
+    using FlushFunction = std::function<void()>;
+
+    struct Options {
+        Options(): cpu(-1), eventLoop(false) {}
+        // Called once all points due on a wake-up were emitted, if at least one was
+        FlushFunction flush;
+        // CPU the scheduler thread is bound to, not bound if negative
+        int           cpu;
+        // Wait on a timerfd/epoll event loop instead of sleeping, only used with the system clock
+        bool          eventLoop;
+    };
+
+    CycleScheduler() = default;
+    ~CycleScheduler();
+    CycleScheduler(const CycleScheduler&) = delete;
+    CycleScheduler& operator=(const CycleScheduler&) = delete;
+
+    void start(std::shared_ptr<Clock> clock, const std::vector<Point>& points, EmitFunction emit,
+               const std::atomic<bool>& enabled, const Options& options = Options());
+    void stop();
+    void wakeUp();
+    bool isRunning() const { return m_thread.joinable(); }
+    bool isUsingEventLoop() const { return m_loop.isOpen(); }
+
+private:
+    void m_run();
+    void m_wait(long deadlineMs, long nowMs);
+
+    std::shared_ptr<Clock>   m_clock;
+    std::thread              m_thread;
+    std::atomic<bool>        m_running{false};
+    const std::atomic<bool> *m_enabled = nullptr;
+    EmitFunction             m_emit;
+    FlushFunction            m_flush;
+    EventLoop                m_loop;
+    std::vector<long>        m_cyclesMs;
+    TimingWheel              m_wheel;
+    std::vector<TimingWheel::Expired> m_due;
+};
+
+};
+
+#endif  // INCLUDE_CYCLE_SCHEDULER_H_
@@ -0,0 +1,71 @@
+#ifndef INCLUDE_EMISSION_STATE_H_
+#define INCLUDE_EMISSION_STATE_H_
+
+/*
+ * Persisted emission times of the cyclic status points
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace systemspn {
+
+/**
+ * Memory mapped file holding the last emission time of each cyclic status point,
+ * so that a restarted plugin resumes the cadence of the previous run.
+ *
+ * Each point has a slot, indexed by its position in the list given to open().
+ * Updating a slot is a plain store in the shared mapping: no system call is made
+ * on the emission path, the kernel writes the dirty page back on its own schedule
+ * and flush() only requests an asynchronous write back.
+ * The file is locked while it is open, it is never shared by two instances.
+ */
+class EmissionState {
+public:
+    EmissionState() = default;
+    ~EmissionState();
+    EmissionState(const EmissionState&) = delete;
+    EmissionState& operator=(const EmissionState&) = delete;
+
+    bool open(const std::string& path, const std::vector<std::pair<std::string, long>>& points);
+    void close();
+    void flush();
+    bool isOpen() const { return m_slots != nullptr; }
+    const std::string& getPath() const { return m_path; }
+    std::size_t getSlotCount() const { return m_slotCount; }
+
+    long getLastEmissionMs(std::size_t slot) const;
+    void setLastEmissionMs(std::size_t slot, long timeMs);
+
+    static long resumeLastEmission(long lastEmissionMs, long cycleMs, long nowMs);
+
+private:
+    struct Header {
+        char     magic[4];
+        uint32_t version;
+        uint64_t slotCount;
+    };
+    struct Slot {
+        uint64_t pivotIdHash;
+        int64_t  cycleMs;
+        int64_t  lastEmissionMs;
+    };
+
+    std::string m_path;
+    int         m_fd = -1;
+    void       *m_mapping = nullptr;
+    std::size_t m_mappingSize = 0;
+    Slot       *m_slots = nullptr;
+    std::size_t m_slotCount = 0;
+};
+
+};
+
+#endif  // INCLUDE_EMISSION_STATE_H_
@@ -0,0 +1,41 @@
+#ifndef INCLUDE_EVENT_LOOP_H_
+#define INCLUDE_EVENT_LOOP_H_
+
+/*
+ * Linux event loop of the cycle scheduler, based on timerfd and epoll
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+namespace systemspn {
+
+/**
+ * Waits on an absolute wall clock deadline armed on a timerfd and on an eventfd used to wake up
+ * the waiting thread (stop, enable toggle, reconfiguration).
+ * The timer is cancelled when the system clock is set, so that a clock change wakes the
+ * waiting thread instead of leaving it asleep until an outdated deadline.
+ */
+class EventLoop {
+public:
+    EventLoop() = default;
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool open();
+    void close();
+    bool isOpen() const { return m_epollFd >= 0; }
+    bool waitUntilMs(long deadlineMs);
+    void wake();
+
+private:
+    int                    m_epollFd = -1;
+    int                    m_timerFd = -1;
+    int                    m_wakeFd = -1;
+};
+
+};
+
+#endif  // INCLUDE_EVENT_LOOP_H_
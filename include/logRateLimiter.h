@@ -0,0 +1,64 @@
+#ifndef INCLUDE_LOG_RATE_LIMITER_H_
+#define INCLUDE_LOG_RATE_LIMITER_H_
+
+/*
+ * Rate limiter for logs issued from hot paths
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "utilityPivot.h"
+
+namespace systemspn {
+
+/**
+ * Limits the number of messages logged for one category during each period.
+ * Debug and info messages on one side, warning and more severe messages on the other side,
+ * have their own budget, so that a flood of verbose messages does not hide errors.
+ * Messages over the limit are counted, and a summary of how many were suppressed is logged
+ * when the period ends, by a thread started on the first suppressed message.
+ */
+class LogRateLimiter {
+public:
+    explicit LogRateLimiter(const char *category, unsigned long maxPerPeriod = 0, long periodMs = 1000);
+    ~LogRateLimiter();
+    LogRateLimiter(const LogRateLimiter&) = delete;
+    LogRateLimiter& operator=(const LogRateLimiter&) = delete;
+
+    bool allow(UtilityPivot::LogLevel level);
+    void setMaxPerPeriod(unsigned long maxPerPeriod) { m_maxPerPeriod = maxPerPeriod; }
+    unsigned long getMaxPerPeriod() const { return m_maxPerPeriod; }
+    unsigned long getSuppressedCount() const { return m_suppressedTotal; }
+    unsigned long getUnreportedCount() const;
+
+private:
+    // Debug and info messages, then warning and more severe messages
+    enum Budget { Verbose = 0, Severe, Budgets };
+
+    void m_endPeriod(long currentTimeMs);
+    void m_runSummary();
+
+    const char                 *m_category;
+    const long                 m_periodMs;
+    std::atomic<unsigned long> m_maxPerPeriod;
+    std::atomic<long>          m_periodStartMs{0};
+    std::atomic<unsigned long> m_countInPeriod[Budgets];
+    std::atomic<unsigned long> m_suppressedInPeriod[Budgets];
+    std::atomic<unsigned long> m_suppressedTotal{0};
+    // Reports the suppressed messages at the end of the periods, once a message was suppressed
+    std::mutex                 m_summaryMutex;
+    std::condition_variable    m_summaryCond;
+    std::thread                m_summaryThread;
+    bool                       m_stopping = false;
+};
+
+};
+
+#endif  // INCLUDE_LOG_RATE_LIMITER_H_
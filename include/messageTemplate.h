@@ -0,0 +1,47 @@
+#ifndef INCLUDE_MESSAGE_TEMPLATE_H_
+#define INCLUDE_MESSAGE_TEMPLATE_H_
+
+/*
+ * Json reading template of the status points, split on its placeholders
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace systemspn {
+
+/**
+ * Reading template split once into literal parts and placeholders
+ * (<pivot_id>, <pivot_type>, <timestamp_sec>, <timestamp_sub_sec> and <value>),
+ * so that filling it is a single pass appending each part to a buffer of the final size.
+ * Any other text between angle brackets is kept as is.
+ */
+class MessageTemplate {
+public:
+    explicit MessageTemplate(const std::string& messageTemplate = "");
+
+    bool empty() const { return m_parts.empty(); }
+    void fill(std::string& message, const std::string& pivotId, const std::string& pivotType,
+              const std::pair<long, long>& timePair, const char *value) const;
+
+private:
+    enum class Field { None, PivotId, PivotType, TimestampSec, TimestampSubSec, Value };
+    // Literal text followed by a placeholder (None for the text at the end of the template)
+    struct Part {
+        std::string text;
+        Field       field;
+    };
+
+    std::vector<Part> m_parts;
+    std::size_t       m_textSize = 0;
+    std::size_t       m_placeholders = 0;
+};
+
+};
+
+#endif  // INCLUDE_MESSAGE_TEMPLATE_H_
@@ -18,8 +18,19 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <vector>
 
+#include "clock.h"
 #include "configPlugin.h"
+#include "cycleScheduler.h"
+#include "emissionState.h"
+#include "logRateLimiter.h"
+#include "messageTemplate.h"
+#include "perfMetrics.h"
+#include "traceRecorder.h"
 
 using FuncPtr = void (*)(void *, void *);
 
@@ -30,34 +41,160 @@ public:
     NotifySystemSp() = default;
     ~NotifySystemSp();
 
+    void initialize(const ConfigCategory& config);
     void reconfigure(const ConfigCategory& config);
+    bool isInitializing() const { return m_initPending; }
+    void waitForInitialization();
     void setJsonConfig(const std::string& jsonExchanged);
     ConfigPlugin& getConfigPlugin() { return m_configPlugin; }
     bool isEnabled() const { return m_enabled; }
 
     void registerIngest(FuncPtr ingest, void *data);
-    void ingest(Reading &reading);
+    bool ingest(Reading &reading);
 
     std::string getMessageTemplate(const std::string& dataType) const;
+    void setClock(std::shared_ptr<Clock> clock);
+    std::shared_ptr<Clock> getClock() const { return m_clock; }
     void startCycles();
     void stopCycles();
-    void runCycles(const std::string& messageTemplate, const std::string& pivotId,
-                   const std::string& pivotType, const std::string& assetName, int cycleSec);
     std::string fillTemplate(const std::string& messageTemplate, const std::string& pivotId,
                              const std::string& pivotType, long timestampMs, bool on = true) const;
-    void sendReading(const std::string& assetName, const std::string& jsonReading);
+    std::string fillTemplate(const std::string& messageTemplate, const std::string& pivotId,
+                             const std::string& pivotType, const std::pair<long, long>& timePair, bool on = true) const;
+    std::string fillTemplate(const MessageTemplate& messageTemplate, const std::string& pivotId,
+                             const std::string& pivotType, const std::pair<long, long>& timePair, bool on = true) const;
+    bool sendReading(const std::string& assetName, const std::string& jsonReading, const std::string& pivotId = "");
     bool notify(const std::string& notificationName, const std::string& triggerReason, const std::string& message);
     bool sendPrtInfSP (bool value);
+    long getGiCoalescingWindowMs() const { return m_giCoalescingWindowMs; }
+    unsigned long getGiTriggersReceived() const { return m_giTriggersReceived; }
+    unsigned long getGiTriggersMerged() const { return m_giTriggersMerged; }
+    unsigned long getLogRateLimit() const { return m_sendReadingLogLimiter.getMaxPerPeriod(); }
+    unsigned long getSuppressedLogsCount() const;
+    PerfMetrics::Snapshot getMetrics() const { return m_metrics.getSnapshot(); }
+    long getLateThresholdMs() const { return m_lateThresholdMs; }
+    long getStartupRampMs() const { return m_startupRampMs; }
+    bool isEmissionStateOpen() const { return m_emissionState.isOpen(); }
+    const std::string& getEmissionStateFile() const { return m_emissionStateFile; }
+    std::size_t getSchedulerShards() const { return m_schedulerShards; }
+    bool isUsingSchedulerEventLoop() const;
+    bool getCycleStats(const std::string& pivotId, CycleStats::Snapshot& snapshot) const;
+    std::map<std::string, CycleStats::Snapshot> getAllCycleStats() const;
+    void startStats(const std::string& assetName, long periodSec);
+    void stopStats();
+    std::string buildStatsJson(const PerfMetrics::Snapshot& current, const PerfMetrics::Snapshot& previous,
+                               long elapsedMs) const;
+    bool dumpTrace(const std::string& filePath = "") const;
 
 private:
+    void m_applyConfig(const ConfigCategory& config, bool importExchangedData);
+    void m_runBackgroundInit(const std::string& jsonExchanged);
+    void m_configureAsyncLogging(bool enabled, const std::string& capacityStr);
+    void m_configureTracing(bool enabled, const std::string& capacityStr, const std::string& filePath);
+    struct SchedulerShard;
+    bool m_emitCyclic(SchedulerShard& shard, std::size_t point, long deadlineMs, long nowMs, bool deadlineValid);
+    Reading* m_buildReading(const std::string& assetName, const std::string& pivotId, const std::string& jsonReading);
+    bool m_ingestLocked(Reading &reading);
+    std::size_t m_ingestBatch(std::vector<std::unique_ptr<Reading>>& readings);
+    void m_flushShard(SchedulerShard& shard);
+    void m_openEmissionState(const std::vector<std::shared_ptr<DataInfo>>& cyclicDataInfos);
+    void m_resetCycleStats(const std::vector<std::shared_ptr<DataInfo>>& cyclicDataInfos);
+    std::shared_ptr<CycleStats> m_getCycleStats(const std::string& pivotId) const;
+    void m_runStats(const std::string& assetName, long periodSec);
+    bool m_parseTriggerReason(const std::string& triggerReason, std::string& asset, std::string& reason);
+    bool m_dispatchNotification(const std::string& asset, const std::string& reason, const std::string& triggerReason);
+    bool m_sendPrtInfSP(bool value);
+    void m_scheduleGiTrailingPulse(long pulseMs);
+    void m_cancelGiTrailingPulse();
+    void m_runGiTrailingPulse(std::shared_ptr<Clock> clock, long pulseMs, std::shared_ptr<std::atomic<bool>> pending,
+                              std::thread previous);
+
     void*	                 m_data = nullptr;
     FuncPtr	                 m_ingest = nullptr;
     mutable std::mutex       m_ingestMutex;
     ConfigPlugin             m_configPlugin;
     mutable std::mutex       m_configMutex;
-    std::vector<std::thread> m_cycleThreads;
+    // Cyclic status points emitted by the scheduler, indexed like its points (only modified while it is stopped)
+    struct CyclicPoint {
+        std::string                 pivotId;
+        std::string                 pivotType;
+        std::string                 assetName;
+        std::shared_ptr<CycleStats> cycleStats;
+    };
+    std::vector<CyclicPoint> m_cyclicPoints;
+    // Reading templates, split once on their placeholders
+    MessageTemplate          m_cyclicTemplate;
+    const MessageTemplate    m_prtInfTemplate{getMessageTemplate("prt.inf")};
+    // Cyclic status points are partitioned by hash of their pivot ID across the scheduler shards,
+    // readings built by a shard on a wake-up are ingested together
+    struct SchedulerShard {
+        CycleScheduler                        scheduler;
+        // Index in m_cyclicPoints of each point of the scheduler
+        std::vector<std::size_t>              points;
+        std::vector<std::unique_ptr<Reading>> batch;
+        // Statistics and deadline of the batched readings whose deviation is recorded when the batch is ingested
+        std::vector<std::pair<CycleStats*, long>> batchDeadlines;
+        // Time of the last tick and its split in seconds and fraction, shared by the points due on it
+        long                                  tickMs = -1;
+        std::pair<long, long>                 tickTime;
+    };
+    std::vector<std::unique_ptr<SchedulerShard>> m_shards;
+    static constexpr std::size_t MaxSchedulerShards = 64;
+    // Readings of a shard are ingested once this many are pending, even if more points are due
+    static constexpr std::size_t MaxShardBatch = 256;
+    std::size_t              m_schedulerShards = 1;
+    bool                     m_schedulerAffinity = false;
+    bool                     m_schedulerEventLoop = true;
     std::atomic<bool>        m_isRunning{false};
     std::atomic<bool>        m_enabled{false};
+    // Import of the exchanged data finished in background after plugin_init (see initialize())
+    std::thread              m_initThread;
+    std::atomic<bool>        m_initPending{false};
+    std::mutex               m_initMutex;
+    std::condition_variable  m_initCond;
+    // Time source of the emissions, only replaced while the cycle threads are stopped
+    std::shared_ptr<Clock>   m_clock = std::make_shared<SystemClock>();
+    // Last emission times persisted across restarts, disabled when m_emissionStateFile is empty
+    // (only opened or closed while the cycle threads are stopped)
+    EmissionState            m_emissionState;
+    std::string              m_emissionStateFile;
+    // Name of the configuration category given to initialize(), distinguishes the default state file of each instance
+    std::string              m_categoryName;
+    // Window over which first emissions are spread by startCycles(), 0 to send them all at start
+    long                     m_startupRampMs = 0;
+    // Coalescing of 'gi_status' finished notifications (m_lastGiPulseMs is protected by m_configMutex)
+    std::atomic<long>          m_giCoalescingWindowMs{0};
+    long                       m_lastGiPulseMs = 0;
+    // Pulse sent at the end of the window when triggers were merged into it, so that the final state
+    // of the last GI is signalled (m_giTrailingPending is replaced under m_configMutex)
+    std::thread                        m_giTrailingThread;
+    std::shared_ptr<std::atomic<bool>> m_giTrailingPending;
+    std::atomic<unsigned long> m_giTriggersReceived{0};
+    std::atomic<unsigned long> m_giTriggersMerged{0};
+    // Counters and latencies of the emission, notification and ingest paths
+    mutable PerfMetrics        m_metrics;
+    // Emission deadline statistics of each cyclic status point, indexed by pivot ID
+    std::map<std::string, std::shared_ptr<CycleStats>> m_cycleStats;
+    mutable std::mutex         m_cycleStatsMutex;
+    std::atomic<long>          m_lateThresholdMs{100};
+    // Telemetry readings (m_statsAsset and m_statsPeriodSec are protected by m_configMutex)
+    std::string                m_statsAsset;
+    long                       m_statsPeriodSec = 60;
+    std::thread                m_statsThread;
+    std::atomic<bool>          m_statsRunning{false};
+    std::mutex                 m_statsMutex;
+    std::condition_variable    m_statsCond;
+    // True when this instance holds a start of the asynchronous logger, with the capacity it requested
+    bool                       m_asyncLoggingStarted = false;
+    long                       m_asyncLoggingCapacity = 0;
+    // True when this instance started span tracing, spans are dumped to m_traceFile at shutdown
+    bool                       m_tracingStarted = false;
+    std::string                m_traceFile;
+    // Rate limiters for logs issued on each hot path
+    static constexpr unsigned long DefaultLogRateLimit = 100;
+    LogRateLimiter             m_sendReadingLogLimiter{"sendReading", DefaultLogRateLimit};
+    LogRateLimiter             m_cyclesLogLimiter{"cycles", DefaultLogRateLimit};
+    LogRateLimiter             m_notifyLogLimiter{"notify", DefaultLogRateLimit};
 };
 };
 
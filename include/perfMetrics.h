@@ -0,0 +1,172 @@
+#ifndef INCLUDE_PERF_METRICS_H_
+#define INCLUDE_PERF_METRICS_H_
+
+/*
+ * Performance metrics of the plugin
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace systemspn {
+
+/**
+ * Lock-free log-linear histogram: values below 8 have their own bucket, then each
+ * power of 2 is split in 4 buckets, so any recorded value is known within 25%.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SubBucketBits = 2;
+    static constexpr int MaxPowerOfTwo = 42;
+    static constexpr int BucketCount = (1 << (SubBucketBits + 1)) + (MaxPowerOfTwo - SubBucketBits) * (1 << SubBucketBits);
+
+    void record(uint64_t value);
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+
+    std::array<std::atomic<uint64_t>, BucketCount> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+};
+
+/**
+ * Plain copy of one or several histograms, used to compute statistics
+ */
+struct HistogramSnapshot {
+    std::array<uint64_t, LatencyHistogram::BucketCount> buckets{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    void merge(const LatencyHistogram& histogram);
+    uint64_t percentile(double percent) const;
+    uint64_t mean() const { return count > 0 ? sum / count : 0; }
+};
+
+/**
+ * Histogram of the emission deviations of one cyclic status point, in ms.
+ * Log-linear as LatencyHistogram: deviations below 32 ms have their own bucket, then each
+ * power of 2 is split in 16 buckets, so that percentiles are known within 6.25%.
+ * Deviations of 2^17 ms (131 s) or more are in the last bucket, and the buckets are 32 bits
+ * counters, so that each of the points costs about 1 KB.
+ */
+class DeviationHistogram {
+public:
+    static constexpr int SubBucketBits = 4;
+    static constexpr int MaxPowerOfTwo = 16;
+    static constexpr int BucketCount = (1 << (SubBucketBits + 1)) + (MaxPowerOfTwo - SubBucketBits) * (1 << SubBucketBits) + 1;
+
+    void record(uint64_t valueMs);
+    uint64_t percentile(double percent) const;
+    static int bucketIndex(uint64_t valueMs);
+    static uint64_t bucketUpperBound(int index);
+
+    std::array<std::atomic<uint32_t>, BucketCount> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> max{0};
+};
+
+/**
+ * Deviation between the actual and the ideal emission time of one cyclic status point
+ */
+struct CycleStats {
+    struct Snapshot {
+        uint64_t emissions = 0;
+        uint64_t lateEmissions = 0;
+        uint64_t p50Ms = 0;
+        uint64_t p99Ms = 0;
+        uint64_t maxMs = 0;
+    };
+
+    void record(long deviation, long lateThresholdMs);
+    Snapshot getSnapshot() const;
+
+    DeviationHistogram    deviationMs;
+    std::atomic<uint64_t> lateEmissions{0};
+};
+
+/**
+ * Counters and latency histograms of the emission, notification and ingest paths.
+ * Each thread records in one of several cache-line aligned slots, so that threads
+ * do not contend on the same atomics, and all slots are aggregated on read.
+ */
+class PerfMetrics {
+public:
+    enum class Counter { ReadingsAcces = 0, ReadingsPrtInf, ReadingsDropped,
+                         NotifyReceived, NotifyAccepted, NotifyRejected, Count };
+    enum class Latency { FillTemplate = 0, BuildReading, IngestCallback,
+                         NotifyParse, NotifyDispatch, Reconfigure, ConfigImport, Count };
+    static constexpr int CounterCount = static_cast<int>(Counter::Count);
+    static constexpr int LatencyCount = static_cast<int>(Latency::Count);
+    static constexpr int SlotCount = 8;
+    static constexpr std::size_t CacheLineSize = 64;
+
+    struct Snapshot {
+        std::array<uint64_t, CounterCount> counters{};
+        std::array<HistogramSnapshot, LatencyCount> latenciesNs{};
+        long cycleThreads = 0;
+        long points = 0;
+
+        uint64_t counter(Counter counterId) const { return counters[static_cast<int>(counterId)]; }
+        const HistogramSnapshot& latencyNs(Latency latencyId) const { return latenciesNs[static_cast<int>(latencyId)]; }
+    };
+
+    /**
+     * Records the time elapsed between its construction and its destruction
+     */
+    class ScopedTimer {
+    public:
+        ScopedTimer(PerfMetrics& metrics, Latency latencyId):
+            m_metrics(metrics), m_latencyId(latencyId), m_start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            m_metrics.recordLatency(m_latencyId, elapsedNs());
+        }
+        uint64_t elapsedNs() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+        }
+    private:
+        PerfMetrics&                          m_metrics;
+        Latency                               m_latencyId;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    PerfMetrics();
+    ~PerfMetrics();
+    PerfMetrics(const PerfMetrics&) = delete;
+    PerfMetrics& operator=(const PerfMetrics&) = delete;
+
+    void increment(Counter counterId, uint64_t value = 1);
+    void recordLatency(Latency latencyId, uint64_t durationNs);
+    void setCycleThreads(long cycleThreads) { m_cycleThreads = cycleThreads; }
+    void setPoints(long points) { m_points = points; }
+    Snapshot getSnapshot() const;
+
+    static const char* getCounterName(Counter counterId);
+    static const char* getLatencyName(Latency latencyId);
+
+private:
+    struct alignas(CacheLineSize) Slot {
+        std::array<std::atomic<uint64_t>, CounterCount> counters{};
+        std::array<LatencyHistogram, LatencyCount> latencies;
+    };
+
+    Slot& m_getSlot();
+
+    // Slots are placed in a manually aligned buffer as C++11 new ignores extended alignment
+    std::unique_ptr<unsigned char[]> m_slotsStorage;
+    Slot*                            m_slots = nullptr;
+    std::atomic<long>           m_cycleThreads{0};
+    std::atomic<long>           m_points{0};
+};
+
+};
+
+#endif  // INCLUDE_PERF_METRICS_H_
@@ -0,0 +1,64 @@
+#ifndef INCLUDE_PROBES_H_
+#define INCLUDE_PROBES_H_
+
+/*
+ * USDT static probes of the emission and notification paths
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+
+/*
+ * Probes are compiled in with the CMake option SYSTEMSPN_USDT (requires sys/sdt.h from systemtap-sdt-dev).
+ * Each probe has a SDT semaphore, incremented by the tracer while it is attached:
+ *
+ *   bpftrace -e 'usdt:/path/to/libsystemspn.so:systemspn:cycle_wakeup { printf("%s %d\n", str(arg0), arg1); }'
+ *
+ * The arguments of a probe are only evaluated while its semaphore is set, an unattached probe
+ * costs the test of its semaphore.
+ *
+ * Probes and arguments:
+ *   cycle_wakeup(pivotId, latenessMs)
+ *   reading_built(pivotId, durationNs)
+ *   ingest_enter(assetName)
+ *   ingest_exit(assetName, durationNs)
+ *   notify_received(triggerReason)
+ *   notify_dispatched(asset, reason, durationNs)
+ *   notify_rejected(asset, reason)
+ *   config_import_start(configSize)
+ *   config_import_end(points, durationNs)
+ *
+ * Without the option, probes expand to nothing and their arguments are not evaluated.
+ */
+#ifdef SYSTEMSPN_USDT
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#define SYSTEMSPN_PROBES(PROBE) \
+    PROBE(cycle_wakeup) PROBE(reading_built) PROBE(ingest_enter) PROBE(ingest_exit) \
+    PROBE(notify_received) PROBE(notify_dispatched) PROBE(notify_rejected) \
+    PROBE(config_import_start) PROBE(config_import_end)
+
+// Semaphores are defined in probes.cpp, sys/sdt.h refers to them by their C name
+#define SYSTEMSPN_PROBE_SEMAPHORE(name) \
+    extern unsigned short systemspn_##name##_semaphore __attribute__((unused, section(".probes")));
+extern "C" {
+SYSTEMSPN_PROBES(SYSTEMSPN_PROBE_SEMAPHORE)
+}
+
+#define SYSTEMSPN_PROBE_ENABLED(name) __builtin_expect(systemspn_##name##_semaphore != 0, 0)
+#define SYSTEMSPN_PROBE1(name, arg1) \
+    do { if (SYSTEMSPN_PROBE_ENABLED(name)) { DTRACE_PROBE1(systemspn, name, arg1); } } while (0)
+#define SYSTEMSPN_PROBE2(name, arg1, arg2) \
+    do { if (SYSTEMSPN_PROBE_ENABLED(name)) { DTRACE_PROBE2(systemspn, name, arg1, arg2); } } while (0)
+#define SYSTEMSPN_PROBE3(name, arg1, arg2, arg3) \
+    do { if (SYSTEMSPN_PROBE_ENABLED(name)) { DTRACE_PROBE3(systemspn, name, arg1, arg2, arg3); } } while (0)
+#else
+#define SYSTEMSPN_PROBE1(name, arg1)             do {} while (0)
+#define SYSTEMSPN_PROBE2(name, arg1, arg2)       do {} while (0)
+#define SYSTEMSPN_PROBE3(name, arg1, arg2, arg3) do {} while (0)
+#endif
+
+#endif  // INCLUDE_PROBES_H_
@@ -0,0 +1,79 @@
+#ifndef INCLUDE_TIMING_WHEEL_H_
+#define INCLUDE_TIMING_WHEEL_H_
+
+/*
+ * Hierarchical timing wheel of the cyclic status point deadlines
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cstdint>
+#include <vector>
+
+namespace systemspn {
+
+/**
+ * Deadlines in ms of a set of entries identified by their index.
+ *
+ * The first level has one slot per ms over 256 ms, each following level has 64 slots
+ * covering the whole previous level (256 ms, 16 s, 17 min and 18 h per slot), so that
+ * deadlines up to 49 days ahead are stored without overflow list. Entries of a slot are
+ * moved to the lower levels when the current time reaches the slot (cascade).
+ * Schedule, reschedule and cancel are O(1), advancing the time skips the empty slots.
+ */
+class TimingWheel {
+public:
+    struct Expired {
+        long        deadlineMs;
+        std::size_t id;
+    };
+
+    TimingWheel() { reset(0); }
+
+    void reset(long nowMs);
+    void schedule(std::size_t id, long deadlineMs);
+    void cancel(std::size_t id);
+    bool isScheduled(std::size_t id) const { return id < m_nodes.size() && m_nodes[id].slot != Nil; }
+    std::size_t size() const { return m_size; }
+    long getCurrentMs() const { return m_currentMs; }
+    void advance(long nowMs, std::vector<Expired>& expired);
+    long getNextDeadlineMs() const;
+
+private:
+    static constexpr uint32_t Nil = UINT32_MAX;
+    static constexpr int      Levels = 5;
+    static constexpr uint32_t FirstLevelSlots = 256;
+    static constexpr uint32_t LevelSlots = 64;
+    static constexpr uint32_t Slots = FirstLevelSlots + (Levels - 1) * LevelSlots;
+    // Number of bits of a deadline below the slot index of each level
+    static constexpr int      LevelShift[Levels] = {0, 8, 14, 20, 26};
+
+    struct Node {
+        long     deadlineMs = 0;
+        uint32_t prev = Nil;
+        uint32_t next = Nil;
+        uint32_t slot = Nil;
+    };
+
+    uint32_t m_slotFor(long deadlineMs) const;
+    void     m_link(uint32_t id, uint32_t slot);
+    void     m_unlink(uint32_t id);
+    void     m_expireSlot(uint32_t slot, std::vector<Expired>& expired);
+    void     m_cascade();
+    int      m_findFirstLevel(uint32_t from) const;
+
+    std::vector<Node> m_nodes;
+    uint32_t          m_heads[Slots];
+    uint32_t          m_tails[Slots];
+    // One bit per non-empty slot, 4 words for the first level then one word per level
+    uint64_t          m_occupied[Slots / 64];
+    // Next ms to be processed by advance(), deadlines before it already expired
+    long              m_currentMs = 0;
+    std::size_t       m_size = 0;
+};
+
+};
+
+#endif  // INCLUDE_TIMING_WHEEL_H_
@@ -0,0 +1,79 @@
+#ifndef INCLUDE_TRACE_RECORDER_H_
+#define INCLUDE_TRACE_RECORDER_H_
+
+/*
+ * In-memory recorder of timed spans, exported as Chrome trace events
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace systemspn {
+
+/**
+ * Records spans in a fixed size ring (oldest spans are overwritten) and dumps them
+ * in the Chrome trace event JSON format, readable by chrome://tracing and Perfetto.
+ * When tracing is disabled, a span only costs one relaxed atomic load.
+ */
+class TraceRecorder {
+public:
+    static constexpr std::size_t DefaultCapacity = 65536;
+
+    /**
+     * Records the time elapsed between its construction and its destruction
+     */
+    class Span {
+    public:
+        explicit Span(const char *name):
+            m_name(name), m_startUs(getInstance().isEnabled() ? nowUs() : 0) {}
+        ~Span() {
+            if (m_startUs > 0) {
+                getInstance().record(m_name, m_startUs, nowUs() - m_startUs);
+            }
+        }
+    private:
+        const char *m_name;
+        uint64_t    m_startUs;
+    };
+
+    static TraceRecorder& getInstance();
+    static uint64_t nowUs();
+
+    void enable(std::size_t capacity = DefaultCapacity);
+    void disable();
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void record(const char *name, uint64_t startUs, uint64_t durationUs);
+    bool dump(const std::string& filePath) const;
+    std::size_t getRecordedCount() const;
+    std::size_t getCapacity() const;
+
+private:
+    struct Event {
+        std::atomic<uint64_t>    sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t>    startUs{0};
+        std::atomic<uint64_t>    durationUs{0};
+        std::atomic<uint32_t>    threadId{0};
+    };
+
+    TraceRecorder() = default;
+    static uint32_t m_getThreadId();
+
+    std::unique_ptr<Event[]> m_events;
+    std::size_t              m_capacity = 0;
+    std::atomic<bool>        m_enabled{false};
+    std::atomic<uint64_t>    m_writeIndex{0};
+    std::atomic<unsigned int> m_writers{0};
+    mutable std::mutex       m_enableMutex;
+};
+
+};
+
+#endif  // INCLUDE_TRACE_RECORDER_H_
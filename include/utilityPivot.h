@@ -14,62 +14,128 @@
 #include <vector>
 #include <logger.h>
 
+#include "asyncLogger.h"
+
 namespace systemspn {
     
 namespace UtilityPivot {  
     // Function for search value
     long                     toTimestamp     (long secondSinceEpoch, long fractionOfSecond);
     std::pair<long, long>    fromTimestamp   (long timestamp);
+    long                     msToFraction    (long ms);
+    long                     fractionToMs    (long fractionOfSecond);
     long                     getCurrentTimestampMs();
+    std::string              getDataDirectory();
     std::string              join(const std::vector<std::string> &list, const std::string &sep = ", ");
     std::vector<std::string> split(const std::string& str, char sep);
 
+    // Size of a buffer holding any long formatted by formatInteger, sign included
+    constexpr std::size_t IntegerBufferSize = 20;
+
+    /*
+     * Writes the decimal representation of value at the start of buffer, without terminating null
+     * character, and returns a pointer past its last digit
+     */
+    char*                    formatInteger(long value, char *buffer);
+
+    // Log levels, ordered by increasing severity
+    enum class LogLevel { Debug = 0, Info, Warning, Error, Fatal };
+
     /*
-     * Log helper function that will log both in the Fledge syslog file and in stdout for unit tests
+     * Tells if a message of the given level would be output by the Fledge logger,
+     * so that callers can skip any formatting work for filtered out messages
+     */
+    bool isLogLevelEnabled(LogLevel level);
+
+    /*
+     * Formats the message and queues it in the asynchronous logger when it is active
+     * Returns false when the message was not handled and must be logged synchronously
      */
     template<class... Args>
-    void log_debug(const std::string& format, Args&&... args) {  
+    bool log_async(LogLevel level, const char *format, Args&&... args) {
+        AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+        if (!asyncLogger.isActive()) {
+            return false;
+        }
+        char message[AsyncLogger::MessageSize];
+        snprintf(message, sizeof(message), format, std::forward<Args>(args)...);
+        // A message dropped because the buffer is full is accounted by the asynchronous logger,
+        // only a logger stopped in the meantime requires a synchronous fallback
+        return asyncLogger.push(level, message) || asyncLogger.isActive();
+    }
+
+    /*
+     * Log helper function that will log both in the Fledge syslog file and in stdout for unit tests.
+     * Nothing is formatted nor forwarded when the message level is below the configured log level.
+     * Fatal messages are always logged synchronously so that they are not lost on a crash.
+     */
+    template<class... Args>
+    void log_debug(const char *format, Args&&... args) {
+        if (!isLogLevelEnabled(LogLevel::Debug)) {
+            return;
+        }
         #ifdef UNIT_TEST
         printf(std::string(format).append("\n").c_str(), std::forward<Args>(args)...);
         fflush(stdout);
         #endif
-        Logger::getLogger()->debug(format.c_str(), std::forward<Args>(args)...);
+        if (log_async(LogLevel::Debug, format, std::forward<Args>(args)...)) {
+            return;
+        }
+        Logger::getLogger()->debug(format, std::forward<Args>(args)...);
     }
 
     template<class... Args>
-    void log_info(const std::string& format, Args&&... args) {    
+    void log_info(const char *format, Args&&... args) {
+        if (!isLogLevelEnabled(LogLevel::Info)) {
+            return;
+        }
         #ifdef UNIT_TEST
         printf(std::string(format).append("\n").c_str(), std::forward<Args>(args)...);
         fflush(stdout);
         #endif
-        Logger::getLogger()->info(format.c_str(), std::forward<Args>(args)...);
+        if (log_async(LogLevel::Info, format, std::forward<Args>(args)...)) {
+            return;
+        }
+        Logger::getLogger()->info(format, std::forward<Args>(args)...);
     }
 
     template<class... Args>
-    void log_warn(const std::string& format, Args&&... args) { 
-        #ifdef UNIT_TEST  
+    void log_warn(const char *format, Args&&... args) {
+        if (!isLogLevelEnabled(LogLevel::Warning)) {
+            return;
+        }
+        #ifdef UNIT_TEST
         printf(std::string(format).append("\n").c_str(), std::forward<Args>(args)...);
         fflush(stdout);
         #endif
-        Logger::getLogger()->warn(format.c_str(), std::forward<Args>(args)...);
+        if (log_async(LogLevel::Warning, format, std::forward<Args>(args)...)) {
+            return;
+        }
+        Logger::getLogger()->warn(format, std::forward<Args>(args)...);
     }
 
     template<class... Args>
-    void log_error(const std::string& format, Args&&... args) {   
+    void log_error(const char *format, Args&&... args) {
+        if (!isLogLevelEnabled(LogLevel::Error)) {
+            return;
+        }
         #ifdef UNIT_TEST
         printf(std::string(format).append("\n").c_str(), std::forward<Args>(args)...);
         fflush(stdout);
         #endif
-        Logger::getLogger()->error(format.c_str(), std::forward<Args>(args)...);
+        if (log_async(LogLevel::Error, format, std::forward<Args>(args)...)) {
+            return;
+        }
+        Logger::getLogger()->error(format, std::forward<Args>(args)...);
     }
 
     template<class... Args>
-    void log_fatal(const std::string& format, Args&&... args) {  
+    void log_fatal(const char *format, Args&&... args) {
         #ifdef UNIT_TEST
         printf(std::string(format).append("\n").c_str(), std::forward<Args>(args)...);
         fflush(stdout);
         #endif
-        Logger::getLogger()->fatal(format.c_str(), std::forward<Args>(args)...);
+        Logger::getLogger()->fatal(format, std::forward<Args>(args)...);
     }
 };
 };
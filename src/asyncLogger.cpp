@@ -0,0 +1,219 @@
+/*
+ * Asynchronous logging backend
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <algorithm>
+#include <cstring>
+#include <logger.h>
+
+#include "asyncLogger.h"
+#include "constantsSystem.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+constexpr std::size_t AsyncLogger::MessageSize;
+constexpr std::size_t AsyncLogger::DefaultCapacity;
+constexpr long AsyncLogger::DefaultFlushPeriodMs;
+
+/**
+ * Get the process wide asynchronous logger
+ *
+ * @return Reference to the asynchronous logger
+*/
+AsyncLogger& AsyncLogger::getInstance() {
+    static AsyncLogger instance;
+    return instance;
+}
+
+/**
+ * Destructor
+*/
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> guard(m_startStopMutex);
+        m_users = std::min(m_users, 1u);
+    }
+    stop();
+}
+
+/**
+ * Allocates the ring buffer and starts the thread forwarding messages to the Fledge logger.
+ * If the logger is already started, only its number of users is increased and it keeps its capacity.
+ *
+ * @param capacity : Maximum number of messages waiting to be logged, rounded up to a power of 2
+ * @param flushPeriodMs : Period in ms at which the waiting messages are forwarded
+*/
+void AsyncLogger::start(std::size_t capacity /*= DefaultCapacity*/, long flushPeriodMs /*= DefaultFlushPeriodMs*/) {
+    std::lock_guard<std::mutex> guard(m_startStopMutex);
+    m_users++;
+    if (m_active) {
+        return;
+    }
+    std::size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_slots.reset(new Slot[size]);
+    for (std::size_t i = 0; i < size; i++) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_mask = size - 1;
+    m_flushPeriodMs = flushPeriodMs;
+    m_enqueuePos = 0;
+    m_dequeuePos = 0;
+    m_stopRequested = false;
+    m_thread = std::thread(&AsyncLogger::m_run, this);
+    m_active = true;
+}
+
+/**
+ * Releases one user of the logger. When it was the last one, stops accepting new messages,
+ * forwards all the waiting ones and stops the background thread
+*/
+void AsyncLogger::stop() {
+    std::lock_guard<std::mutex> guard(m_startStopMutex);
+    if (m_users > 0) {
+        m_users--;
+    }
+    if (!m_active || m_users > 0) {
+        return;
+    }
+    m_active = false;
+    // Wait for emitting threads that may still be copying a message
+    while (m_producers > 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> wakeGuard(m_wakeMutex);
+        m_stopRequested = true;
+    }
+    m_wakeCond.notify_one();
+    m_thread.join();
+
+    unsigned long dropped = m_dropped;
+    if (dropped > 0) {
+        Logger::getLogger()->warn("%s - AsyncLogger::stop : %lu messages dropped because the buffer was full",
+                                  FILTER_NAME, dropped);
+    }
+}
+
+/**
+ * Get the number of users that started the logger and did not stop it yet
+ *
+ * @return Number of users
+*/
+unsigned int AsyncLogger::getUsers() const {
+    std::lock_guard<std::mutex> guard(m_startStopMutex);
+    return m_users;
+}
+
+/**
+ * Copies a message in the ring buffer, without blocking.
+ *
+ * @param level : Level of the message
+ * @param message : Formatted message, truncated to MessageSize
+ * @return True if the message was queued, false if the logger is not active or the buffer is full
+*/
+bool AsyncLogger::push(UtilityPivot::LogLevel level, const char *message) {
+    m_producers++;
+    if (!m_active) {
+        m_producers--;
+        return false;
+    }
+    std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &m_slots[pos & m_mask];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // Buffer is full
+            m_dropped++;
+            m_producers--;
+            return false;
+        }
+        else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->level = level;
+    std::strncpy(slot->message, message, MessageSize - 1);
+    slot->message[MessageSize - 1] = '\0';
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    m_producers--;
+    return true;
+}
+
+/**
+ * Get the number of messages currently waiting to be logged
+ *
+ * @return Number of queued messages
+*/
+std::size_t AsyncLogger::getQueuedCount() const {
+    std::size_t enqueuePos = m_enqueuePos;
+    std::size_t dequeuePos = m_dequeuePos;
+    return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+}
+
+/**
+ * Background thread function, periodically forwarding the waiting messages
+*/
+void AsyncLogger::m_run() {
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (!m_stopRequested) {
+        m_wakeCond.wait_for(lock, std::chrono::milliseconds(m_flushPeriodMs));
+        lock.unlock();
+        m_flush();
+        lock.lock();
+    }
+    lock.unlock();
+    m_flush();
+}
+
+/**
+ * Forwards all the messages currently in the ring buffer to the Fledge logger
+ *
+ * @return Number of messages forwarded
+*/
+std::size_t AsyncLogger::m_flush() {
+    std::size_t count = 0;
+    for (;;) {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[pos & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break;
+        }
+        switch (slot.level) {
+            case UtilityPivot::LogLevel::Debug:
+                Logger::getLogger()->debug("%s", slot.message);
+                break;
+            case UtilityPivot::LogLevel::Info:
+                Logger::getLogger()->info("%s", slot.message);
+                break;
+            case UtilityPivot::LogLevel::Warning:
+                Logger::getLogger()->warn("%s", slot.message);
+                break;
+            case UtilityPivot::LogLevel::Error:
+                Logger::getLogger()->error("%s", slot.message);
+                break;
+            default:
+                Logger::getLogger()->fatal("%s", slot.message);
+                break;
+        }
+        slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        count++;
+    }
+    m_flushed += count;
+    return count;
+}
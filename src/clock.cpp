@@ -0,0 +1,170 @@
+/*
+ * Time source of the emission scheduling
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "clock.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+constexpr long VirtualClock::DefaultSettleTimeoutMs;
+
+/**
+ * Get the current time
+ *
+ * @return Current time in ms since epoch
+*/
+long SystemClock::nowMs() {
+    return UtilityPivot::getCurrentTimestampMs();
+}
+
+/**
+ * Sleeps the current thread
+ *
+ * @param durationMs : Duration of the sleep in ms
+ * @param running : The sleep is interrupted when it becomes false and notifyStop() is called
+*/
+void SystemClock::sleepForMs(long durationMs, const std::atomic<bool>& running) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stopCond.wait_for(lock, std::chrono::milliseconds(durationMs), [&running]() { return !running; });
+}
+
+/**
+ * Wakes up the sleeping threads whose running flag was set to false
+*/
+void SystemClock::notifyStop() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stopCond.notify_all();
+}
+
+/**
+ * Get the current simulated time
+ *
+ * @return Simulated time in ms
+*/
+long VirtualClock::nowMs() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_nowMs;
+}
+
+/**
+ * Sleeps the current thread until the simulated time has moved forward by the given duration
+ *
+ * @param durationMs : Duration of the sleep in ms of simulated time
+ * @param running : The sleep is interrupted when it becomes false and notifyStop() is called
+*/
+void VirtualClock::sleepForMs(long durationMs, const std::atomic<bool>& running) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!running) {
+        return;
+    }
+    Sleeper sleeper;
+    auto it = m_sleepers.emplace(m_nowMs + std::max(durationMs, 0L), &sleeper);
+    m_sleepCond.notify_all();
+    m_wakeCond.wait(lock, [&sleeper, &running]() { return sleeper.woken || !running; });
+    if (!sleeper.woken) {
+        m_sleepers.erase(it);
+        m_sleepCond.notify_all();
+    }
+}
+
+/**
+ * Wakes up the sleeping threads whose running flag was set to false
+*/
+void VirtualClock::notifyStop() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_wakeCond.notify_all();
+}
+
+/**
+ * Declares a thread about to be started, advance() waits for it to sleep before moving the time
+*/
+void VirtualClock::addParticipant() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_participants++;
+}
+
+/**
+ * Declares that a participant thread is exiting
+*/
+void VirtualClock::removeParticipant() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_participants > 0) {
+        m_participants--;
+    }
+    m_sleepCond.notify_all();
+}
+
+/**
+ * Get the number of participant threads
+ *
+ * @return Number of threads added and not removed yet
+*/
+unsigned int VirtualClock::getParticipants() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_participants;
+}
+
+/**
+ * Get the number of sleeping threads
+ *
+ * @return Number of threads waiting for the time to move forward
+*/
+std::size_t VirtualClock::getSleepers() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_sleepers.size();
+}
+
+/**
+ * Waits until all participant threads are sleeping
+ *
+ * @param settleTimeoutMs : Maximum wall clock time to wait in ms
+ * @return True if all participants are sleeping, false on timeout
+*/
+bool VirtualClock::waitForSleepers(long settleTimeoutMs /*= DefaultSettleTimeoutMs*/) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_waitForSleepers(lock, settleTimeoutMs);
+}
+
+bool VirtualClock::m_waitForSleepers(std::unique_lock<std::mutex>& lock, long settleTimeoutMs) {
+    return m_sleepCond.wait_for(lock, std::chrono::milliseconds(settleTimeoutMs),
+                                [this]() { return m_sleepers.size() >= m_participants; });
+}
+
+/**
+ * Moves the simulated time forward, one deadline at a time.
+ * At each deadline, the threads sleeping until then are woken up and the time only moves further
+ * once all participants are sleeping again.
+ *
+ * @param durationMs : Duration in ms of simulated time to move forward
+ * @param settleTimeoutMs : Maximum wall clock time in ms to wait for participants at each deadline
+ * @return True if all participants are sleeping at the end, false if they did not settle in time
+*/
+bool VirtualClock::advance(long durationMs, long settleTimeoutMs /*= DefaultSettleTimeoutMs*/) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    long targetMs = m_nowMs + std::max(durationMs, 0L);
+    while (true) {
+        if (!m_waitForSleepers(lock, settleTimeoutMs)) {
+            return false;
+        }
+        if (m_sleepers.empty() || (m_sleepers.begin()->first > targetMs)) {
+            m_nowMs = targetMs;
+            return true;
+        }
+        m_nowMs = m_sleepers.begin()->first;
+        auto end = m_sleepers.upper_bound(m_nowMs);
+        for (auto it = m_sleepers.begin(); it != end; ++it) {
+            it->second->woken = true;
+        }
+        m_sleepers.erase(m_sleepers.begin(), end);
+        m_wakeCond.notify_all();
+    }
+}
@@ -4,6 +4,7 @@
 #include <set>
 
 #include "configPlugin.h"
+#include "configSnapshot.h"
 #include "constantsSystem.h"
 #include "utilityPivot.h"
 
@@ -20,56 +21,98 @@ ConfigPlugin::ConfigPlugin() {
  * Import data in the form of Exchanged_data
  * The data is saved in a map m_exchangeDefinitions
  *
+ * When a snapshot directory is set, the data is restored from the snapshot of the
+ * same configuration if there is one, else a snapshot is written after the import
+ *
  * @param exchangeConfig : configuration Exchanged_data as a string
 */
 void ConfigPlugin::importExchangedData(const std::string & exchangeConfig) {
+    constexpr const char *beforeLog = FILTER_NAME " - ConfigPlugin::importExchangedData :";
+    m_loadedFromSnapshot = false;
+    if (m_snapshotDirectory.empty()) {
+        m_parseExchangedData(exchangeConfig);
+        return;
+    }
+
+    uint64_t hash = ConfigSnapshot::hash(exchangeConfig);
+    std::string snapshotPath = ConfigSnapshot::getPath(m_snapshotDirectory, m_snapshotInstance, hash);
+    m_reset();
+    if (ConfigSnapshot::load(snapshotPath, hash, exchangeConfig.size(), m_dataSystem)) {
+        m_loadedFromSnapshot = true;
+        UtilityPivot::log_info("%s Configuration restored from snapshot %s", beforeLog, snapshotPath.c_str());
+    }
+    else {
+        if (!m_parseExchangedData(exchangeConfig)) {
+            return;
+        }
+        if (!ConfigSnapshot::write(snapshotPath, hash, exchangeConfig.size(), m_dataSystem)) {
+            return;
+        }
+        UtilityPivot::log_info("%s Configuration snapshot written to %s", beforeLog, snapshotPath.c_str());
+    }
+    // Only the snapshot of the current configuration is kept, including across restarts
+    ConfigSnapshot::removeOthers(m_snapshotDirectory, m_snapshotInstance, snapshotPath);
+}
+
+/**
+ * Parse a configuration in the form of Exchanged_data and import its datapoints
+ *
+ * @param exchangeConfig : configuration Exchanged_data as a string
+ * @return False if the configuration could not be parsed
+*/
+bool ConfigPlugin::m_parseExchangedData(const std::string & exchangeConfig) {
 
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - ConfigPlugin::importExchangedData :";
+    constexpr const char *beforeLog = FILTER_NAME " - ConfigPlugin::importExchangedData :";
     rapidjson::Document document;
 
     m_reset();
 
     if (document.Parse(exchangeConfig.c_str()).HasParseError()) {
-        UtilityPivot::log_fatal("%s Parsing error in data exchange configuration", beforeLog.c_str());
-        return;
+        UtilityPivot::log_fatal("%s Parsing error in data exchange configuration", beforeLog);
+        return false;
     }
 
     if (!document.IsObject()) {
-        UtilityPivot::log_fatal("%s Root element is not an object", beforeLog.c_str());
-        return;
+        UtilityPivot::log_fatal("%s Root element is not an object", beforeLog);
+        return false;
     }
 
     if (!document.HasMember(ConstantsSystem::JsonExchangedData) || !document[ConstantsSystem::JsonExchangedData].IsObject()) {
-        UtilityPivot::log_fatal("%s exchanged_data not found in root object or is not an object", beforeLog.c_str());
-        return;
+        UtilityPivot::log_fatal("%s exchanged_data not found in root object or is not an object", beforeLog);
+        return false;
     }
     const rapidjson::Value& exchangeData = document[ConstantsSystem::JsonExchangedData];
 
     if (!exchangeData.HasMember(ConstantsSystem::JsonDatapoints) || !exchangeData[ConstantsSystem::JsonDatapoints].IsArray()) {
-        UtilityPivot::log_fatal("%s datapoints not found in exchanged_data or is not an array", beforeLog.c_str());
-        return;
+        UtilityPivot::log_fatal("%s datapoints not found in exchanged_data or is not an array", beforeLog);
+        return false;
     }
     const rapidjson::Value& datapoints = exchangeData[ConstantsSystem::JsonDatapoints];
 
     for (const rapidjson::Value& datapoint : datapoints.GetArray()) {
         m_importDatapoint(datapoint);
     }
+    return true;
 }
 
 /**
  * Import data from a single datapoint of exchanged data
  *
+ * The cycle of an "acces" status point is ts_syst_cycle_ms (milliseconds) if present, else ts_syst_cycle (seconds).
+ * A ts_syst_cycle_ms which is not an integer is a configuration error, the point is ignored
+ * even if it also has a valid ts_syst_cycle.
+ *
  * @param datapoint : datapoint to parse and import
 */
 void ConfigPlugin::m_importDatapoint(const rapidjson::Value& datapoint) {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - ConfigPlugin::m_importDatapoint :";
+    constexpr const char *beforeLog = FILTER_NAME " - ConfigPlugin::m_importDatapoint :";
     if (!datapoint.IsObject()) {
-        UtilityPivot::log_error("%s datapoint is not an object", beforeLog.c_str());
+        UtilityPivot::log_error("%s datapoint is not an object", beforeLog);
         return;
     }
 
     if (!datapoint.HasMember(ConstantsSystem::JsonPivotType) || !datapoint[ConstantsSystem::JsonPivotType].IsString()) {
-        UtilityPivot::log_error("%s pivot_type not found in datapoint or is not a string", beforeLog.c_str());
+        UtilityPivot::log_error("%s pivot_type not found in datapoint or is not a string", beforeLog);
         return;
     }
 
@@ -80,7 +123,7 @@ void ConfigPlugin::m_importDatapoint(const rapidjson::Value& datapoint) {
     }
 
     if (!datapoint.HasMember(ConstantsSystem::JsonPivotId) || !datapoint[ConstantsSystem::JsonPivotId].IsString()) {
-        UtilityPivot::log_error("%s pivot_id not found in datapoint or is not a string", beforeLog.c_str());
+        UtilityPivot::log_error("%s pivot_id not found in datapoint or is not a string", beforeLog);
         return;
     }
     std::string pivot_id = datapoint[ConstantsSystem::JsonPivotId].GetString();
@@ -91,7 +134,7 @@ void ConfigPlugin::m_importDatapoint(const rapidjson::Value& datapoint) {
     }
 
     if (!datapoint.HasMember(ConstantsSystem::JsonLabel) || !datapoint[ConstantsSystem::JsonLabel].IsString()) {
-        UtilityPivot::log_error("%s label not found in datapoint or is not a string", beforeLog.c_str());
+        UtilityPivot::log_error("%s label not found in datapoint or is not a string", beforeLog);
         return;
     }
     std::string label = datapoint[ConstantsSystem::JsonLabel].GetString();
@@ -112,14 +155,38 @@ void ConfigPlugin::m_importDatapoint(const rapidjson::Value& datapoint) {
     }
 
     if (foundConfigs.count("acces") > 0) {
-        if (!datapoint.HasMember(ConstantsSystem::JsonTsSystCycle) || !datapoint[ConstantsSystem::JsonTsSystCycle].IsInt()) {
-            UtilityPivot::log_error("%s Configuration access on %s, but no %s found", beforeLog.c_str(), label.c_str(), ConstantsSystem::JsonTsSystCycle);
+        // A cycle in milliseconds takes precedence over a cycle in seconds. When present,
+        // ts_syst_cycle_ms must be a valid integer: ts_syst_cycle is then never used as a fallback
+        long cycleMs = 0;
+        bool validCycle = false;
+        if (datapoint.HasMember(ConstantsSystem::JsonTsSystCycleMs)) {
+            if (!datapoint[ConstantsSystem::JsonTsSystCycleMs].IsInt64()) {
+                UtilityPivot::log_error("%s Configuration access on %s, %s is not an integer", beforeLog, label.c_str(),
+                                        ConstantsSystem::JsonTsSystCycleMs);
+            }
+            else {
+                cycleMs = static_cast<long>(datapoint[ConstantsSystem::JsonTsSystCycleMs].GetInt64());
+                validCycle = true;
+            }
+        }
+        else if (datapoint.HasMember(ConstantsSystem::JsonTsSystCycle) && datapoint[ConstantsSystem::JsonTsSystCycle].IsInt()) {
+            cycleMs = 1000L * datapoint[ConstantsSystem::JsonTsSystCycle].GetInt();
+            validCycle = true;
         }
         else {
-            int cycle_s = datapoint[ConstantsSystem::JsonTsSystCycle].GetInt();
-            addDataInfo("acces", std::make_shared<CyclicDataInfo>(pivot_id, type, label, cycle_s));
-            UtilityPivot::log_debug("%s Configuration access on %s : [%s, %s, %d]",
-                                    beforeLog.c_str(), label.c_str(), pivot_id.c_str(), type.c_str(), cycle_s);
+            UtilityPivot::log_error("%s Configuration access on %s, but no %s or %s found", beforeLog, label.c_str(),
+                                    ConstantsSystem::JsonTsSystCycleMs, ConstantsSystem::JsonTsSystCycle);
+        }
+
+        if (validCycle && cycleMs <= 0) {
+            UtilityPivot::log_error("%s Configuration access on %s, cycle (%s, or %s in seconds) must be positive: %ld ms",
+                                    beforeLog, label.c_str(), ConstantsSystem::JsonTsSystCycleMs,
+                                    ConstantsSystem::JsonTsSystCycle, cycleMs);
+        }
+        else if (validCycle) {
+            addDataInfo("acces", std::make_shared<CyclicDataInfo>(pivot_id, type, label, cycleMs));
+            UtilityPivot::log_debug("%s Configuration access on %s : [%s, %s, %ld ms]",
+                                    beforeLog, label.c_str(), pivot_id.c_str(), type.c_str(), cycleMs);
         }
     }
 
@@ -127,12 +194,12 @@ void ConfigPlugin::m_importDatapoint(const rapidjson::Value& datapoint) {
         if (foundConfigs.count("transient") > 0){
             addDataInfo("prt.inf", std::make_shared<DataInfo>(pivot_id, type, label, false));
             UtilityPivot::log_debug("%s Configuration prt.inf on %s : [%s, %s]",
-                                    beforeLog.c_str(), label.c_str(), pivot_id.c_str(), type.c_str());
+                                    beforeLog, label.c_str(), pivot_id.c_str(), type.c_str());
         }
         else {
             addDataInfo("prt.inf", std::make_shared<DataInfo>(pivot_id, type, label, true));
             UtilityPivot::log_warn("%s Configuration prt.inf on %s : no transient subtype found, prt.inf is always transient",
-                                    beforeLog.c_str(), label.c_str());
+                                    beforeLog, label.c_str());
         }
     }
 }
@@ -145,9 +212,9 @@ void ConfigPlugin::m_importDatapoint(const rapidjson::Value& datapoint) {
  * @return True if a result is found, else false
 */
 bool ConfigPlugin::hasDataForType(const std::string& dataType, const std::string& pivotId) const {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - ConfigPlugin::hasDataForType :";
+    constexpr const char *beforeLog = FILTER_NAME " - ConfigPlugin::hasDataForType :";
     if (m_dataSystem.count(dataType) == 0) {
-        UtilityPivot::log_error("%s Invalid dataType: %s", beforeLog.c_str(), dataType.c_str());
+        UtilityPivot::log_error("%s Invalid dataType: %s", beforeLog, dataType.c_str());
         return false;
     }
     const auto& dataSystem = m_dataSystem.at(dataType);
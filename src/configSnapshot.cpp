@@ -0,0 +1,326 @@
+/*
+ * Binary snapshot of the imported exchanged data
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "configSnapshot.h"
+#include "constantsSystem.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+namespace {
+    constexpr char     Magic[4] = {'S', 'P', 'N', 'C'};
+    constexpr uint32_t Version = 2;
+
+    struct Header {
+        char     magic[4];
+        uint32_t version;
+        uint64_t hash;
+        uint64_t sourceSize;
+        uint64_t payloadSize;
+        uint32_t dataTypes;
+        uint32_t reserved;
+    };
+
+    enum PointFlags : uint8_t { Cyclic = 1, TransientWarning = 2 };
+
+    // Bounds checked reader of the memory mapped snapshot
+    class Reader {
+    public:
+        Reader(const char *begin, const char *end): m_current(begin), m_end(end) {}
+
+        template<class T>
+        bool read(T& value) {
+            if (static_cast<std::size_t>(m_end - m_current) < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, m_current, sizeof(T));
+            m_current += sizeof(T);
+            return true;
+        }
+
+        bool readString(std::string& value) {
+            uint32_t size = 0;
+            if (!read(size) || static_cast<std::size_t>(m_end - m_current) < size) {
+                return false;
+            }
+            value.assign(m_current, size);
+            m_current += size;
+            return true;
+        }
+
+        bool atEnd() const { return m_current == m_end; }
+
+    private:
+        const char *m_current;
+        const char *m_end;
+    };
+
+    template<class T>
+    void append(std::string& buffer, const T& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void appendString(std::string& buffer, const std::string& value) {
+        append(buffer, static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    // Write the whole buffer to the file, retrying partial and interrupted writes
+    bool writeAll(int fd, const char *data, std::size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    bool readDataSystem(Reader& reader, uint32_t dataTypes, ConfigSnapshot::DataSystem& dataSystem) {
+        for (uint32_t i = 0; i < dataTypes; i++) {
+            std::string dataType;
+            uint32_t points = 0;
+            if (!reader.readString(dataType) || !reader.read(points)) {
+                return false;
+            }
+            auto& dataInfos = dataSystem[dataType];
+            dataInfos.reserve(points);
+            for (uint32_t j = 0; j < points; j++) {
+                uint8_t flags = 0;
+                int64_t cycleMs = 0;
+                std::string pivotId;
+                std::string pivotType;
+                std::string assetName;
+                if (!reader.read(flags) || !reader.read(cycleMs) || !reader.readString(pivotId) ||
+                    !reader.readString(pivotType) || !reader.readString(assetName)) {
+                    return false;
+                }
+                if (flags & Cyclic) {
+                    dataInfos.push_back(std::make_shared<CyclicDataInfo>(pivotId, pivotType, assetName,
+                                                                         static_cast<long>(cycleMs)));
+                }
+                else {
+                    dataInfos.push_back(std::make_shared<DataInfo>(pivotId, pivotType, assetName,
+                                                                   (flags & TransientWarning) != 0));
+                }
+            }
+        }
+        return reader.atEnd();
+    }
+}
+
+/**
+ * Hash of an exchanged_data configuration (64 bits FNV-1a)
+ *
+ * @param exchangedData : configuration Exchanged_data as a string
+ * @return Hash of the configuration
+*/
+uint64_t ConfigSnapshot::hash(const std::string& exchangedData) {
+    uint64_t value = 14695981039346656037ULL;
+    for (unsigned char c : exchangedData) {
+        value ^= c;
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+/**
+ * Prefix of the snapshot file names of an instance
+ *
+ * @param instanceName : Name of the plugin instance, may be empty
+ * @return Prefix of the file names, followed by the hash and ".snapshot"
+*/
+static std::string getPrefix(const std::string& instanceName) {
+    return FILTER_NAME "_" + (instanceName.empty() ? std::string() : instanceName + "_") + "config_";
+}
+
+/**
+ * Path of the snapshot of a configuration
+ *
+ * @param directory : Directory of the snapshots
+ * @param instanceName : Name of the plugin instance owning the snapshot, may be empty
+ * @param hash : Hash of the configuration
+ * @return Path of the snapshot file
+*/
+std::string ConfigSnapshot::getPath(const std::string& directory, const std::string& instanceName, uint64_t hash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.snapshot", static_cast<unsigned long long>(hash));
+    return directory + "/" + getPrefix(instanceName) + name;
+}
+
+/**
+ * Remove the snapshots of an instance other than the given one, left by previous configurations
+ * Only the files named as getPath() names them for this instance are removed
+ *
+ * @param directory : Directory of the snapshots
+ * @param instanceName : Name of the plugin instance owning the snapshots, may be empty
+ * @param keptPath : Path of the snapshot to keep
+ * @return Number of snapshots removed
+*/
+int ConfigSnapshot::removeOthers(const std::string& directory, const std::string& instanceName,
+                                 const std::string& keptPath) {
+    constexpr const char *beforeLog = FILTER_NAME " - ConfigSnapshot::removeOthers :";
+    constexpr std::size_t HashDigits = 16;
+    static const std::string suffix = ".snapshot";
+    const std::string prefix = getPrefix(instanceName);
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    int removed = 0;
+    while (const struct dirent *entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        // The hash must follow the prefix directly, so that the snapshots of an instance
+        // whose name starts with this one are not removed
+        if (name.size() != prefix.size() + HashDigits + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(prefix.size() + HashDigits, suffix.size(), suffix) != 0 ||
+            name.find_first_not_of("0123456789abcdef", prefix.size()) != prefix.size() + HashDigits) {
+            continue;
+        }
+        const std::string path = directory + "/" + name;
+        if (path == keptPath) {
+            continue;
+        }
+        if (std::remove(path.c_str()) == 0) {
+            removed++;
+        }
+        else {
+            UtilityPivot::log_warn("%s Cannot remove snapshot %s", beforeLog, path.c_str());
+        }
+    }
+    closedir(dir);
+    return removed;
+}
+
+/**
+ * Restore the point tables from a snapshot, by memory mapping the file
+ *
+ * @param path : Path of the snapshot file
+ * @param hash : Hash of the configuration expected in the snapshot
+ * @param sourceSize : Size of the configuration expected in the snapshot
+ * @param dataSystem : Point tables to fill, left in an undefined state on failure
+ * @return True if the snapshot matches the configuration and was fully read
+*/
+bool ConfigSnapshot::load(const std::string& path, uint64_t hash, uint64_t sourceSize, DataSystem& dataSystem) {
+    constexpr const char *beforeLog = FILTER_NAME " - ConfigSnapshot::load :";
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || static_cast<std::size_t>(fileStat.st_size) < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+    std::size_t fileSize = static_cast<std::size_t>(fileStat.st_size);
+    void *mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        UtilityPivot::log_warn("%s Cannot map snapshot %s", beforeLog, path.c_str());
+        return false;
+    }
+    const char *data = static_cast<const char*>(mapping);
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    bool loaded = false;
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) {
+        UtilityPivot::log_warn("%s Unsupported snapshot format in %s", beforeLog, path.c_str());
+    }
+    else if (header.hash != hash || header.sourceSize != sourceSize) {
+        UtilityPivot::log_warn("%s Snapshot %s does not match the configuration", beforeLog, path.c_str());
+    }
+    else if (header.payloadSize != fileSize - sizeof(Header)) {
+        UtilityPivot::log_warn("%s Truncated snapshot %s", beforeLog, path.c_str());
+    }
+    else {
+        Reader reader(data + sizeof(Header), data + fileSize);
+        loaded = readDataSystem(reader, header.dataTypes, dataSystem);
+        if (!loaded) {
+            UtilityPivot::log_warn("%s Corrupted snapshot %s", beforeLog, path.c_str());
+        }
+    }
+    munmap(mapping, fileSize);
+    return loaded;
+}
+
+/**
+ * Write the point tables to a snapshot, replacing the file atomically
+ *
+ * @param path : Path of the snapshot file
+ * @param hash : Hash of the configuration the tables were imported from
+ * @param sourceSize : Size of the configuration the tables were imported from
+ * @param dataSystem : Point tables to write
+ * @return True if the snapshot was written
+*/
+bool ConfigSnapshot::write(const std::string& path, uint64_t hash, uint64_t sourceSize, const DataSystem& dataSystem) {
+    constexpr const char *beforeLog = FILTER_NAME " - ConfigSnapshot::write :";
+    std::string payload;
+    for (const auto& dataTypeInfos : dataSystem) {
+        appendString(payload, dataTypeInfos.first);
+        append(payload, static_cast<uint32_t>(dataTypeInfos.second.size()));
+        for (const auto& dataInfo : dataTypeInfos.second) {
+            auto cyclicDataInfo = std::dynamic_pointer_cast<CyclicDataInfo>(dataInfo);
+            uint8_t flags = (cyclicDataInfo ? Cyclic : 0) | (dataInfo->isTransientWarning ? TransientWarning : 0);
+            append(payload, flags);
+            append(payload, static_cast<int64_t>(cyclicDataInfo ? cyclicDataInfo->cycleMs : 0));
+            appendString(payload, dataInfo->pivotId);
+            appendString(payload, dataInfo->pivotType);
+            appendString(payload, dataInfo->assetName);
+        }
+    }
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.hash = hash;
+    header.sourceSize = sourceSize;
+    header.payloadSize = payload.size();
+    header.dataTypes = static_cast<uint32_t>(dataSystem.size());
+    header.reserved = 0;
+
+    // Written to a file of its own next to the final file, synced then renamed, so that a reader
+    // never sees a partial snapshot and concurrent writers do not share the temporary file
+    std::vector<char> tmpPath(path.begin(), path.end());
+    const char tmpSuffix[] = ".XXXXXX";
+    tmpPath.insert(tmpPath.end(), tmpSuffix, tmpSuffix + sizeof(tmpSuffix));
+    int fd = mkstemp(tmpPath.data());
+    if (fd < 0) {
+        UtilityPivot::log_warn("%s Cannot create snapshot %s: %s", beforeLog, tmpPath.data(), strerror(errno));
+        return false;
+    }
+    bool written = writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(Header)) &&
+                   writeAll(fd, payload.data(), payload.size()) && fsync(fd) == 0;
+    if (close(fd) != 0) {
+        written = false;
+    }
+    if (!written) {
+        UtilityPivot::log_warn("%s Cannot write snapshot %s", beforeLog, tmpPath.data());
+        unlink(tmpPath.data());
+        return false;
+    }
+    if (std::rename(tmpPath.data(), path.c_str()) != 0) {
+        UtilityPivot::log_warn("%s Cannot rename snapshot %s", beforeLog, tmpPath.data());
+        unlink(tmpPath.data());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,172 @@
+/*
+ * Scheduler of the cyclic status point emissions
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <algorithm>
+#include <climits>
+#include <pthread.h>
+#include <sched.h>
+
+#include "cycleScheduler.h"
+#include "constantsSystem.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+constexpr long CycleScheduler::MaxSleepMs;
+constexpr long CycleScheduler::DisabledPollMs;
+
+/**
+ * Destructor, the scheduler thread is stopped
+ */
+CycleScheduler::~CycleScheduler() {
+    stop();
+}
+
+/**
+ * Start the scheduler thread for the given points
+ *
+ * @param clock Time source of the deadlines
+ * @param points Cycle and first deadline of each point, a point is identified by its index in this list
+ * @param emit Function called for each due point
+ * @param enabled No point is emitted while false, must outlive the scheduler thread,
+ *                wakeUp() must be called when it becomes true
+ * @param options Flush function, CPU affinity and event loop of the scheduler thread
+ */
+void CycleScheduler::start(std::shared_ptr<Clock> clock, const std::vector<Point>& points, EmitFunction emit,
+                           const std::atomic<bool>& enabled, const Options& options /*= Options()*/) {
+    constexpr const char *beforeLog = FILTER_NAME " - CycleScheduler::start :";
+    stop();
+    m_clock = clock;
+    m_emit = emit;
+    m_flush = options.flush;
+    // The kernel timer follows the wall clock, any other time source is waited on through the clock
+    if (options.eventLoop && std::dynamic_pointer_cast<SystemClock>(m_clock) && !m_loop.open()) {
+        UtilityPivot::log_warn("%s Event loop unavailable, scheduler thread sleeps on the clock", beforeLog);
+    }
+    m_enabled = &enabled;
+    m_cyclesMs.clear();
+    m_cyclesMs.reserve(points.size());
+    m_wheel.reset(m_clock->nowMs());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        // A null cycle would emit the point continuously
+        m_cyclesMs.push_back(std::max(points[i].cycleMs, 1L));
+        m_wheel.schedule(i, points[i].firstDeadlineMs);
+    }
+    m_running = true;
+    m_clock->addParticipant();
+    m_thread = std::thread(&CycleScheduler::m_run, this);
+    int cpu = options.cpu;
+    if (cpu >= 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        int result = pthread_setaffinity_np(m_thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+        if (result != 0) {
+            UtilityPivot::log_warn("%s Cannot bind scheduler thread to CPU %d (error %d)", beforeLog, cpu, result);
+        }
+    }
+}
+
+/**
+ * Stop the scheduler thread, returns once it exited
+ */
+void CycleScheduler::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_running = false;
+    m_clock->notifyStop();
+    m_loop.wake();
+    m_thread.join();
+    m_loop.close();
+}
+
+/**
+ * Interrupt the wait of the scheduler thread, so that it checks again whether emissions are enabled.
+ * Without event loop, the thread polls the enabled flag and nothing is done.
+ */
+void CycleScheduler::wakeUp() {
+    m_loop.wake();
+}
+
+/**
+ * Wait of the scheduler thread until the next deadline
+ *
+ * @param deadlineMs Time to wake up at, LONG_MAX if there is none
+ * @param nowMs Current time
+ */
+void CycleScheduler::m_wait(long deadlineMs, long nowMs) {
+    if (m_loop.isOpen()) {
+        m_loop.waitUntilMs(deadlineMs);
+    }
+    else {
+        m_clock->sleepForMs(std::min(deadlineMs - nowMs, MaxSleepMs), m_running);
+    }
+}
+
+/**
+ * Thread function of the scheduler
+ */
+void CycleScheduler::m_run() {
+    ClockParticipant participant(*m_clock);
+    // Points emitted at least once since emissions were last enabled
+    std::vector<bool> deadlineValid(m_cyclesMs.size(), false);
+    bool wasEnabled = true;
+    while (m_running) {
+        if (!*m_enabled) {
+            // Deadlines missed while emissions were disabled are not counted as late
+            if (wasEnabled) {
+                std::fill(deadlineValid.begin(), deadlineValid.end(), false);
+                wasEnabled = false;
+            }
+            long nowMs = m_clock->nowMs();
+            m_wait(m_loop.isOpen() ? LONG_MAX : nowMs + DisabledPollMs, nowMs);
+            continue;
+        }
+        wasEnabled = true;
+        // One clock sample per tick, shared by all the points due on it
+        long nowMs = m_clock->nowMs();
+        bool emitted = false;
+        m_due.clear();
+        m_wheel.advance(nowMs, m_due);
+        for (const auto& entry : m_due) {
+            if (!m_running || !*m_enabled) {
+                // Points not emitted yet stay due
+                m_wheel.schedule(entry.id, entry.deadlineMs);
+                continue;
+            }
+            if (!m_emit(entry.id, entry.deadlineMs, nowMs, deadlineValid[entry.id])) {
+                continue;
+            }
+            deadlineValid[entry.id] = true;
+            emitted = true;
+            long cycleMs = m_cyclesMs[entry.id];
+            long nextDeadlineMs = entry.deadlineMs + cycleMs;
+            if (nextDeadlineMs <= nowMs) {
+                // Late by more than a cycle, missed deadlines are skipped: the next one is the first
+                // deadline of the original cadence after now, so that the phase of the point is kept
+                nextDeadlineMs += ((nowMs - nextDeadlineMs) / cycleMs + 1) * cycleMs;
+            }
+            m_wheel.schedule(entry.id, nextDeadlineMs);
+        }
+        if (emitted && m_flush) {
+            m_flush();
+        }
+        if (m_due.empty()) {
+            m_wait(m_wheel.getNextDeadlineMs(), nowMs);
+        }
+        else {
+            // Points may have become due while the tick was emitted
+            long afterMs = m_clock->nowMs();
+            long nextMs = m_wheel.getNextDeadlineMs();
+            if (nextMs > afterMs) {
+                m_wait(nextMs, afterMs);
+            }
+        }
+    }
+}
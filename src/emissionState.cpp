@@ -0,0 +1,197 @@
+/*
+ * Persisted emission times of the cyclic status points
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "constantsSystem.h"
+#include "emissionState.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+namespace {
+    constexpr char     Magic[4] = {'S', 'P', 'N', 'E'};
+    constexpr uint32_t Version = 1;
+
+    // 64 bits FNV-1a, slots are matched by the hash of their pivot ID
+    uint64_t hashPivotId(const std::string& pivotId) {
+        uint64_t value = 14695981039346656037ULL;
+        for (unsigned char c : pivotId) {
+            value ^= c;
+            value *= 1099511628211ULL;
+        }
+        return value;
+    }
+}
+
+/**
+ * Destructor, the mapping is released
+ */
+EmissionState::~EmissionState() {
+    close();
+}
+
+/**
+ * Open the state file for the given points, creating it if needed.
+ * Emission times stored by a previous run are kept for the points having the same pivot ID and cycle,
+ * other slots start without emission time. The file is rewritten with the slots of the given points.
+ * The file is locked until close(), it cannot be opened by another instance at the same time.
+ *
+ * @param path : Path of the state file
+ * @param points : Pivot ID and emission cycle (ms) of each cyclic status point, in slot order
+ * @return False if the file could not be opened, locked or mapped
+ */
+bool EmissionState::open(const std::string& path, const std::vector<std::pair<std::string, long>>& points) {
+    constexpr const char *beforeLog = FILTER_NAME " - EmissionState::open :";
+    close();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        UtilityPivot::log_error("%s Cannot open emission state file %s: %s", beforeLog, path.c_str(), strerror(errno));
+        return false;
+    }
+    // Resizing the file would drop the slots of the other instance and fault its mapping
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        UtilityPivot::log_error("%s Emission state file %s is already used by another instance: %s", beforeLog,
+                                path.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    // Emission times of the previous run, indexed by pivot ID hash and cycle
+    std::map<std::pair<uint64_t, int64_t>, int64_t> previousEmissions;
+    struct stat fileStat;
+    Header header;
+    if (fstat(fd, &fileStat) == 0 && static_cast<std::size_t>(fileStat.st_size) >= sizeof(Header) &&
+        pread(fd, &header, sizeof(Header), 0) == static_cast<ssize_t>(sizeof(Header))) {
+        std::size_t expectedSize = sizeof(Header) + header.slotCount * sizeof(Slot);
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version ||
+            static_cast<std::size_t>(fileStat.st_size) != expectedSize) {
+            UtilityPivot::log_warn("%s Invalid emission state file %s, previous emission times ignored",
+                                   beforeLog, path.c_str());
+        }
+        else {
+            std::vector<Slot> slots(header.slotCount);
+            std::size_t slotsSize = slots.size() * sizeof(Slot);
+            if (pread(fd, slots.data(), slotsSize, sizeof(Header)) == static_cast<ssize_t>(slotsSize)) {
+                for (const auto& slot : slots) {
+                    previousEmissions[std::make_pair(slot.pivotIdHash, slot.cycleMs)] = slot.lastEmissionMs;
+                }
+            }
+        }
+    }
+
+    std::size_t mappingSize = sizeof(Header) + points.size() * sizeof(Slot);
+    if (ftruncate(fd, static_cast<off_t>(mappingSize)) != 0) {
+        UtilityPivot::log_error("%s Cannot resize emission state file %s: %s", beforeLog, path.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void *mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        UtilityPivot::log_error("%s Cannot map emission state file %s: %s", beforeLog, path.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    Header *newHeader = static_cast<Header*>(mapping);
+    std::memcpy(newHeader->magic, Magic, sizeof(Magic));
+    newHeader->version = Version;
+    newHeader->slotCount = points.size();
+    Slot *slots = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(Header));
+    std::size_t restored = 0;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        slots[i].pivotIdHash = hashPivotId(points[i].first);
+        slots[i].cycleMs = points[i].second;
+        auto previous = previousEmissions.find(std::make_pair(slots[i].pivotIdHash, slots[i].cycleMs));
+        slots[i].lastEmissionMs = previous != previousEmissions.end() ? previous->second : 0;
+        restored += previous != previousEmissions.end() ? 1 : 0;
+    }
+    m_path = path;
+    m_fd = fd;
+    m_mapping = mapping;
+    m_mappingSize = mappingSize;
+    m_slots = slots;
+    m_slotCount = points.size();
+    UtilityPivot::log_info("%s Emission times of %lu/%lu status points restored from %s", beforeLog,
+                           static_cast<unsigned long>(restored), static_cast<unsigned long>(points.size()), path.c_str());
+    return true;
+}
+
+/**
+ * Write back and release the mapping and the lock of the state file
+ */
+void EmissionState::close() {
+    if (m_mapping == nullptr) {
+        return;
+    }
+    flush();
+    munmap(m_mapping, m_mappingSize);
+    // Closing the descriptor releases the lock
+    ::close(m_fd);
+    m_fd = -1;
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_slots = nullptr;
+    m_slotCount = 0;
+}
+
+/**
+ * Request an asynchronous write back of the stored emission times
+ */
+void EmissionState::flush() {
+    if (m_mapping != nullptr) {
+        msync(m_mapping, m_mappingSize, MS_ASYNC);
+    }
+}
+
+/**
+ * Get the last emission time stored for a status point
+ *
+ * @param slot : Index of the status point
+ * @return Last emission time in ms, 0 if unknown
+ */
+long EmissionState::getLastEmissionMs(std::size_t slot) const {
+    return (m_slots != nullptr && slot < m_slotCount) ? static_cast<long>(m_slots[slot].lastEmissionMs) : 0;
+}
+
+/**
+ * Store the last emission time of a status point, only the thread emitting the point writes its slot
+ *
+ * @param slot : Index of the status point
+ * @param timeMs : Emission time in ms
+ */
+void EmissionState::setLastEmissionMs(std::size_t slot, long timeMs) {
+    if (m_slots != nullptr && slot < m_slotCount) {
+        m_slots[slot].lastEmissionMs = timeMs;
+    }
+}
+
+/**
+ * Compute the emission time from which the cadence of a status point is resumed:
+ * the last slot of the previous cadence that is not in the future, so that the next
+ * emission happens at the next slot, neither earlier nor later than without the restart.
+ *
+ * @param lastEmissionMs : Last emission time stored by the previous run, 0 if unknown
+ * @param cycleMs : Emission cycle in ms
+ * @param nowMs : Current time in ms
+ * @return Last emission time to use, 0 to emit immediately
+ */
+long EmissionState::resumeLastEmission(long lastEmissionMs, long cycleMs, long nowMs) {
+    if (lastEmissionMs <= 0 || cycleMs <= 0 || lastEmissionMs > nowMs) {
+        return 0;
+    }
+    // A slot falling exactly now is due, it must not be skipped
+    return lastEmissionMs + ((nowMs - lastEmissionMs - 1) / cycleMs) * cycleMs;
+}
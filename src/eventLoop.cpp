@@ -0,0 +1,125 @@
+/*
+ * Linux event loop of the cycle scheduler, based on timerfd and epoll
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "constantsSystem.h"
+#include "eventLoop.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+/**
+ * Destructor, the file descriptors of the loop are closed
+ */
+EventLoop::~EventLoop() {
+    close();
+}
+
+/**
+ * Create the epoll instance, the timer and the wake-up event
+ *
+ * @return False if one of them could not be created, the loop stays closed
+ */
+bool EventLoop::open() {
+    constexpr const char *beforeLog = FILTER_NAME " - EventLoop::open :";
+    close();
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_timerFd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_timerFd < 0 || m_wakeFd < 0) {
+        UtilityPivot::log_warn("%s Cannot create event loop: %s", beforeLog, strerror(errno));
+        close();
+        return false;
+    }
+    for (int fd : {m_timerFd, m_wakeFd}) {
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            UtilityPivot::log_warn("%s Cannot register event loop descriptor: %s", beforeLog, strerror(errno));
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Close the file descriptors of the loop, no thread may be waiting on it
+ */
+void EventLoop::close() {
+    for (int *fd : {&m_wakeFd, &m_timerFd, &m_epollFd}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+/**
+ * Wait until a deadline, a call to wake() or a change of the system clock.
+ *
+ * @param deadlineMs Absolute deadline in ms since epoch, LONG_MAX to wait without deadline
+ * @return True if the deadline was reached
+ */
+bool EventLoop::waitUntilMs(long deadlineMs) {
+    if (!isOpen()) {
+        return false;
+    }
+    struct itimerspec timerSpec;
+    std::memset(&timerSpec, 0, sizeof(timerSpec));
+    if (deadlineMs != LONG_MAX) {
+        // A null value disarms the timer, a deadline at the epoch is already passed anyway
+        long armedMs = deadlineMs > 0 ? deadlineMs : 1;
+        timerSpec.it_value.tv_sec = armedMs / 1000;
+        timerSpec.it_value.tv_nsec = (armedMs % 1000) * 1000000L;
+    }
+    timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &timerSpec, nullptr);
+
+    constexpr int MaxEvents = 8;
+    struct epoll_event events[MaxEvents];
+    int count = 0;
+    do {
+        count = epoll_wait(m_epollFd, events, MaxEvents, -1);
+    } while (count < 0 && errno == EINTR);
+
+    bool deadlineReached = false;
+    for (int i = 0; i < count; i++) {
+        int fd = events[i].data.fd;
+        uint64_t value = 0;
+        if (fd == m_timerFd) {
+            // Fails with ECANCELED when the system clock was set
+            deadlineReached = read(m_timerFd, &value, sizeof(value)) == sizeof(value);
+        }
+        else if (fd == m_wakeFd) {
+            ssize_t result = read(m_wakeFd, &value, sizeof(value));
+            (void)result;
+        }
+    }
+    return deadlineReached;
+}
+
+/**
+ * Wake up the thread waiting in waitUntilMs(), or make its next wait return immediately
+ */
+void EventLoop::wake() {
+    if (m_wakeFd >= 0) {
+        uint64_t value = 1;
+        ssize_t result = write(m_wakeFd, &value, sizeof(value));
+        (void)result;
+    }
+}
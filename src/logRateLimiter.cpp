@@ -0,0 +1,141 @@
+/*
+ * Rate limiter for logs issued from hot paths
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <chrono>
+
+#include "logRateLimiter.h"
+#include "constantsSystem.h"
+
+using namespace systemspn;
+
+/**
+ * Constructor
+ *
+ * @param category : Name of the logs category, used in the suppressed messages summary
+ * @param maxPerPeriod : Maximum number of messages of each budget allowed in each period (0 = unlimited)
+ * @param periodMs : Duration of a period in ms
+*/
+LogRateLimiter::LogRateLimiter(const char *category, unsigned long maxPerPeriod /*= 0*/, long periodMs /*= 1000*/):
+    m_category(category), m_periodMs(periodMs), m_maxPerPeriod(maxPerPeriod) {
+    for (int budget = 0; budget < Budgets; budget++) {
+        m_countInPeriod[budget] = 0;
+        m_suppressedInPeriod[budget] = 0;
+    }
+}
+
+/**
+ * Destructor, the summary thread is stopped without reporting the current period
+*/
+LogRateLimiter::~LogRateLimiter() {
+    {
+        std::lock_guard<std::mutex> guard(m_summaryMutex);
+        m_stopping = true;
+    }
+    m_summaryCond.notify_all();
+    if (m_summaryThread.joinable()) {
+        m_summaryThread.join();
+    }
+}
+
+/**
+ * Tells if a message of the given level can be logged now.
+ * Messages filtered out by the log level do not consume any of the period budget.
+ *
+ * @param level : Level of the message to log
+ * @return True if the message must be logged, else false
+*/
+bool LogRateLimiter::allow(UtilityPivot::LogLevel level) {
+    if (!UtilityPivot::isLogLevelEnabled(level)) {
+        return false;
+    }
+    unsigned long maxPerPeriod = m_maxPerPeriod;
+    if (maxPerPeriod == 0) {
+        return true;
+    }
+
+    long currentTimeMs = UtilityPivot::getCurrentTimestampMs();
+    if (currentTimeMs - m_periodStartMs >= m_periodMs) {
+        m_endPeriod(currentTimeMs);
+    }
+
+    int budget = level >= UtilityPivot::LogLevel::Warning ? Severe : Verbose;
+    if (m_countInPeriod[budget]++ < maxPerPeriod) {
+        return true;
+    }
+    m_suppressedTotal++;
+    if (m_suppressedInPeriod[budget]++ == 0) {
+        // First message suppressed in the period, its summary is due at the end of the period
+        std::lock_guard<std::mutex> guard(m_summaryMutex);
+        if (!m_summaryThread.joinable()) {
+            m_summaryThread = std::thread(&LogRateLimiter::m_runSummary, this);
+        }
+        m_summaryCond.notify_all();
+    }
+    return false;
+}
+
+/**
+ * Number of messages suppressed during the current period, not reported yet
+ *
+ * @return Number of messages of all budgets
+*/
+unsigned long LogRateLimiter::getUnreportedCount() const {
+    return m_suppressedInPeriod[Verbose] + m_suppressedInPeriod[Severe];
+}
+
+/**
+ * Opens a new period if the current one is over, and reports the messages suppressed during it
+ *
+ * @param currentTimeMs : Current time in ms
+*/
+void LogRateLimiter::m_endPeriod(long currentTimeMs) {
+    constexpr const char *beforeLog = FILTER_NAME " - LogRateLimiter::m_endPeriod :";
+    long periodStartMs = m_periodStartMs;
+    if ((currentTimeMs - periodStartMs < m_periodMs) ||
+        !m_periodStartMs.compare_exchange_strong(periodStartMs, currentTimeMs)) {
+        return;
+    }
+    // Only the thread that opened the new period reports on the previous one
+    for (int budget = 0; budget < Budgets; budget++) {
+        m_countInPeriod[budget] = 0;
+    }
+    unsigned long suppressed = m_suppressedInPeriod[Severe].exchange(0);
+    if (suppressed > 0) {
+        UtilityPivot::log_error("%s %lu '%s' warning or error messages suppressed during last %ld ms",
+                                beforeLog, suppressed, m_category, currentTimeMs - periodStartMs);
+    }
+    suppressed = m_suppressedInPeriod[Verbose].exchange(0);
+    if (suppressed > 0) {
+        UtilityPivot::log_warn("%s %lu '%s' debug or info messages suppressed during last %ld ms",
+                               beforeLog, suppressed, m_category, currentTimeMs - periodStartMs);
+    }
+}
+
+/**
+ * Thread function reporting the suppressed messages at the end of each period where some were,
+ * even if no other message of the category is logged afterwards
+*/
+void LogRateLimiter::m_runSummary() {
+    std::unique_lock<std::mutex> lock(m_summaryMutex);
+    while (!m_stopping) {
+        if (getUnreportedCount() == 0) {
+            m_summaryCond.wait(lock, [this]() { return m_stopping || getUnreportedCount() > 0; });
+            continue;
+        }
+        long currentTimeMs = UtilityPivot::getCurrentTimestampMs();
+        long periodEndMs = m_periodStartMs + m_periodMs;
+        if (currentTimeMs < periodEndMs) {
+            m_summaryCond.wait_for(lock, std::chrono::milliseconds(periodEndMs - currentTimeMs),
+                                   [this]() { return m_stopping; });
+            continue;
+        }
+        lock.unlock();
+        m_endPeriod(currentTimeMs);
+        lock.lock();
+    }
+}
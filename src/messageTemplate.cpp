@@ -0,0 +1,98 @@
+/*
+ * Json reading template of the status points, split on its placeholders
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <algorithm>
+#include <cstring>
+
+#include "messageTemplate.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+/**
+ * Split a reading template on its placeholders
+ *
+ * @param messageTemplate : Json reading template, as returned by NotifySystemSp::getMessageTemplate
+ */
+MessageTemplate::MessageTemplate(const std::string& messageTemplate) {
+    static const std::vector<std::pair<std::string, Field>> placeholders = {
+        {"<pivot_id>", Field::PivotId},
+        {"<pivot_type>", Field::PivotType},
+        {"<timestamp_sec>", Field::TimestampSec},
+        {"<timestamp_sub_sec>", Field::TimestampSubSec},
+        {"<value>", Field::Value},
+    };
+    std::string text;
+    std::size_t pos = 0;
+    while (pos < messageTemplate.size()) {
+        std::size_t start = messageTemplate.find('<', pos);
+        if (start == std::string::npos) {
+            text.append(messageTemplate, pos, std::string::npos);
+            break;
+        }
+        text.append(messageTemplate, pos, start - pos);
+        auto placeholder = std::find_if(placeholders.begin(), placeholders.end(),
+            [&messageTemplate, start](const std::pair<std::string, Field>& candidate) {
+                return messageTemplate.compare(start, candidate.first.size(), candidate.first) == 0;
+            });
+        if (placeholder == placeholders.end()) {
+            text.push_back('<');
+            pos = start + 1;
+            continue;
+        }
+        m_textSize += text.size();
+        m_placeholders++;
+        m_parts.push_back({text, placeholder->second});
+        text.clear();
+        pos = start + placeholder->first.size();
+    }
+    if (!text.empty()) {
+        m_textSize += text.size();
+        m_parts.push_back({text, Field::None});
+    }
+}
+
+/**
+ * Fill the template with the values of a reading
+ *
+ * @param message : Destination, replaced by the filled template
+ * @param pivotId : Value of <pivot_id>
+ * @param pivotType : Value of <pivot_type>
+ * @param timePair : Values of <timestamp_sec> and <timestamp_sub_sec>, as returned by UtilityPivot::fromTimestamp
+ * @param value : Value of <value>, already formatted as json
+ */
+void MessageTemplate::fill(std::string& message, const std::string& pivotId, const std::string& pivotType,
+                           const std::pair<long, long>& timePair, const char *value) const {
+    std::size_t valueSize = std::strlen(value);
+    std::size_t maxFieldSize = std::max({pivotId.size(), pivotType.size(), valueSize, UtilityPivot::IntegerBufferSize});
+    message.clear();
+    message.reserve(m_textSize + m_placeholders * maxFieldSize);
+    char digits[UtilityPivot::IntegerBufferSize];
+    for (const auto& part : m_parts) {
+        message.append(part.text);
+        switch (part.field) {
+            case Field::PivotId:
+                message.append(pivotId);
+                break;
+            case Field::PivotType:
+                message.append(pivotType);
+                break;
+            case Field::TimestampSec:
+                message.append(digits, UtilityPivot::formatInteger(timePair.first, digits));
+                break;
+            case Field::TimestampSubSec:
+                message.append(digits, UtilityPivot::formatInteger(timePair.second, digits));
+                break;
+            case Field::Value:
+                message.append(value, valueSize);
+                break;
+            case Field::None:
+                break;
+        }
+    }
+}
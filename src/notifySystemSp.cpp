@@ -8,7 +8,10 @@
  * Author: Yannick Marchetaux
  *
  */
-#include <regex>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
 #include <datapoint.h>
 #include <reading.h>
 #include <plugin_api.h>
@@ -17,6 +20,7 @@
 #include "notifySystemSp.h"
 #include "constantsSystem.h"
 #include "datapoint_utility.h"
+#include "probes.h"
 #include "utilityPivot.h"
 
 using namespace DatapointUtility;
@@ -26,7 +30,25 @@ using namespace systemspn;
  * Destructor for the NotifySystemSp class.
  */
 NotifySystemSp::~NotifySystemSp() {
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    }
     stopCycles();
+    stopStats();
+    {
+        std::lock_guard<std::mutex> guard(m_configMutex);
+        m_cancelGiTrailingPulse();
+    }
+    if (m_giTrailingThread.joinable()) {
+        m_giTrailingThread.join();
+    }
+    if (m_tracingStarted) {
+        dumpTrace();
+        TraceRecorder::getInstance().disable();
+    }
+    if (m_asyncLoggingStarted) {
+        AsyncLogger::getInstance().stop();
+    }
 }
 
 /**
@@ -35,7 +57,18 @@ NotifySystemSp::~NotifySystemSp() {
  * @param jsonExchanged : configuration ExchangedData
  */
 void NotifySystemSp::setJsonConfig(const std::string& jsonExchanged) {
-    m_configPlugin.importExchangedData(jsonExchanged);
+    {
+        SYSTEMSPN_PROBE1(config_import_start, jsonExchanged.size());
+        PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::ConfigImport);
+        m_configPlugin.importExchangedData(jsonExchanged);
+        const auto& dataSystem = m_configPlugin.getDataSystem();
+        long points = static_cast<long>(dataSystem.at("acces").size() + dataSystem.at("prt.inf").size());
+        m_metrics.setPoints(points);
+        SYSTEMSPN_PROBE2(config_import_end, points, timer.elapsedNs());
+    }
+    // New prt.inf points must not be hidden by a pulse sent for the previous configuration
+    m_lastGiPulseMs = 0;
+    m_cancelGiTrailingPulse();
     // Reinitialize cyclic messages
     startCycles();
 }
@@ -47,7 +80,7 @@ void NotifySystemSp::setJsonConfig(const std::string& jsonExchanged) {
  * @return Json reading template
  */
 std::string NotifySystemSp::getMessageTemplate(const std::string& dataType) const {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::getMessageTemplate : ";
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::getMessageTemplate : ";
     if ((dataType == "acces") || (dataType == "prt.inf")) {
         return QUOTE({
             "PIVOT": {
@@ -74,7 +107,7 @@ std::string NotifySystemSp::getMessageTemplate(const std::string& dataType) cons
         });
     }
     else {
-        UtilityPivot::log_fatal("%s Invalid data type: %s", beforeLog.c_str(), dataType.c_str());
+        UtilityPivot::log_fatal("%s Invalid data type: %s", beforeLog, dataType.c_str());
         return "";
     }
 }
@@ -83,86 +116,266 @@ std::string NotifySystemSp::getMessageTemplate(const std::string& dataType) cons
  * For each cyclic status point in the configuration, starts the cycle to send it periodically
  */
 void NotifySystemSp::startCycles() {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::startCycles : ";
-    UtilityPivot::log_debug("%s Starting configured cycles...", beforeLog.c_str());
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::startCycles : ";
+    UtilityPivot::log_debug("%s Starting configured cycles...", beforeLog);
 
     // If any cycle was already in progress, stop them
     stopCycles();
 
-    // Start a new cycle thread for each cyclic status point
+    // All cyclic status points are emitted by the scheduler shards
     m_isRunning = true;
-    std::string messageTemplate = getMessageTemplate("acces");
+    m_cyclicTemplate = MessageTemplate(getMessageTemplate("acces"));
     const auto& dataSystem = m_configPlugin.getDataSystem();
-    for(const auto& dataInfo : dataSystem.at("acces")) {
+    const auto& cyclicDataInfos = dataSystem.at("acces");
+    m_resetCycleStats(cyclicDataInfos);
+    m_openEmissionState(cyclicDataInfos);
+    // Rank of each point in pivot ID order, first emissions are spread in that order
+    std::vector<std::size_t> pivotIdOrder(cyclicDataInfos.size());
+    std::iota(pivotIdOrder.begin(), pivotIdOrder.end(), 0);
+    std::stable_sort(pivotIdOrder.begin(), pivotIdOrder.end(), [&cyclicDataInfos](std::size_t a, std::size_t b) {
+        return cyclicDataInfos[a]->pivotId < cyclicDataInfos[b]->pivotId;
+    });
+    std::vector<std::size_t> rampRank(cyclicDataInfos.size());
+    for(std::size_t rank = 0; rank < pivotIdOrder.size(); rank++) {
+        rampRank[pivotIdOrder[rank]] = rank;
+    }
+    m_cyclicPoints.clear();
+    m_cyclicPoints.reserve(cyclicDataInfos.size());
+    std::size_t shardCount = std::max<std::size_t>(m_schedulerShards, 1);
+    std::vector<std::vector<CycleScheduler::Point>> schedulerPoints(shardCount);
+    m_shards.clear();
+    for(std::size_t i = 0; i < shardCount; i++) {
+        m_shards.emplace_back(new SchedulerShard());
+    }
+    long currentTimeMs = m_clock->nowMs();
+    for(std::size_t slot = 0; slot < cyclicDataInfos.size(); slot++) {
         // All data infos from access status points are cyclic ones
-        auto cyclicDataInfo = std::dynamic_pointer_cast<CyclicDataInfo>(dataInfo);
-        m_cycleThreads.push_back(
-            std::thread(&NotifySystemSp::runCycles, this, messageTemplate, cyclicDataInfo->pivotId, cyclicDataInfo->pivotType,
-                        cyclicDataInfo->assetName, cyclicDataInfo->cycleSec)
-        );
+        auto cyclicDataInfo = std::dynamic_pointer_cast<CyclicDataInfo>(cyclicDataInfos[slot]);
+        long cycleMs = cyclicDataInfo->cycleMs;
+        // Resume the cadence of the previous run instead of emitting all points at once
+        long lastEmissionMs = EmissionState::resumeLastEmission(m_emissionState.getLastEmissionMs(slot),
+                                                                cycleMs, currentTimeMs);
+        long firstDeadlineMs = lastEmissionMs > 0 ? lastEmissionMs + cycleMs : currentTimeMs;
+        if (lastEmissionMs == 0 && m_startupRampMs > 0) {
+            // Without previous cadence, the first emission is delayed by the rank of the point in the ramp
+            int64_t windowMs = std::min(cycleMs, m_startupRampMs);
+            int64_t delayMs = static_cast<int64_t>(rampRank[slot]) * windowMs / static_cast<int64_t>(cyclicDataInfos.size());
+            firstDeadlineMs = currentTimeMs + static_cast<long>(delayMs);
+        }
+        m_cyclicPoints.push_back({cyclicDataInfo->pivotId, cyclicDataInfo->pivotType, cyclicDataInfo->assetName,
+                                  m_getCycleStats(cyclicDataInfo->pivotId)});
+        std::size_t shard = std::hash<std::string>()(cyclicDataInfo->pivotId) % shardCount;
+        m_shards[shard]->points.push_back(slot);
+        schedulerPoints[shard].push_back({cycleMs, firstDeadlineMs});
+    }
+    unsigned int cpus = std::max(std::thread::hardware_concurrency(), 1u);
+    long cycleThreads = 0;
+    for(std::size_t i = 0; i < shardCount; i++) {
+        SchedulerShard *shard = m_shards[i].get();
+        if (shard->points.empty()) {
+            continue;
+        }
+        CycleScheduler::Options options;
+        shard->batch.reserve(MaxShardBatch);
+        shard->batchDeadlines.reserve(MaxShardBatch);
+        options.flush = [this, shard]() { m_flushShard(*shard); };
+        options.cpu = m_schedulerAffinity ? static_cast<int>(i % cpus) : -1;
+        options.eventLoop = m_schedulerEventLoop;
+        shard->scheduler.start(m_clock, schedulerPoints[i],
+                               [this, shard](std::size_t point, long deadlineMs, long nowMs, bool deadlineValid) {
+                                   return m_emitCyclic(*shard, point, deadlineMs, nowMs, deadlineValid);
+                               }, m_enabled, options);
+        cycleThreads++;
     }
+    m_metrics.setCycleThreads(cycleThreads);
+
+    UtilityPivot::log_debug("%s Cycles started!", beforeLog);
+}
 
-    UtilityPivot::log_debug("%s Cycles started!", beforeLog.c_str());
+/**
+ * Check whether the running scheduler shards wait on a timerfd/epoll event loop
+ *
+ * @return True if at least one shard is running and all running shards use an event loop
+ */
+bool NotifySystemSp::isUsingSchedulerEventLoop() const {
+    std::lock_guard<std::mutex> guard(m_configMutex);
+    bool running = false;
+    for(const auto& shard : m_shards) {
+        if (shard->scheduler.isRunning()) {
+            if (!shard->scheduler.isUsingEventLoop()) {
+                return false;
+            }
+            running = true;
+        }
+    }
+    return running;
+}
+
+/**
+ * Replaces the time source of the emissions, running cycles are restarted on the new clock
+ *
+ * @param clock New time source, system clock if null
+ */
+void NotifySystemSp::setClock(std::shared_ptr<Clock> clock) {
+    waitForInitialization();
+    std::lock_guard<std::mutex> guard(m_configMutex);
+    bool wasRunning = m_isRunning;
+    stopCycles();
+    m_cancelGiTrailingPulse();
+    m_clock = clock ? clock : std::make_shared<SystemClock>();
+    // Times of the previous clock are meaningless for the new one
+    m_lastGiPulseMs = 0;
+    if (wasRunning) {
+        startCycles();
+    }
 }
 
 /**
  * Stops all status point emission cycles
  */
 void NotifySystemSp::stopCycles() {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::stopCycles : ";
-    UtilityPivot::log_debug("%s Stopping all existing cycles...", beforeLog.c_str());
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::stopCycles : ";
+    UtilityPivot::log_debug("%s Stopping all existing cycles...", beforeLog);
 
     m_isRunning = false;
-    for(auto& thread: m_cycleThreads) {
-        thread.join();
+    for(auto& shard : m_shards) {
+        shard->scheduler.stop();
     }
-    m_cycleThreads.clear();
+    m_metrics.setCycleThreads(0);
+    // Written back and unlocked, reopened by the next startCycles()
+    m_emissionState.close();
 
-    UtilityPivot::log_debug("%s Cycles stopped!", beforeLog.c_str());
+    UtilityPivot::log_debug("%s Cycles stopped!", beforeLog);
 }
 
 /**
- * Thread function used to send one status point periodically
+ * Creates the emission statistics of the given cyclic status points.
+ * Statistics of status points already known are kept, the ones of removed status points are dropped.
  *
- * @param messageTemplate String containing the template of the reading json message to send
- * @param pivotId Pivot ID to use in the message
- * @param pivotType Pivot Type to use in the message
- * @param assetName Asset name to use for the message
- * @param cycleSec Period in seconds when to send the message
+ * @param cyclicDataInfos Data infos of all cyclic status points
+ */
+void NotifySystemSp::m_resetCycleStats(const std::vector<std::shared_ptr<DataInfo>>& cyclicDataInfos) {
+    std::lock_guard<std::mutex> guard(m_cycleStatsMutex);
+    std::map<std::string, std::shared_ptr<CycleStats>> cycleStats;
+    for(const auto& dataInfo : cyclicDataInfos) {
+        auto it = m_cycleStats.find(dataInfo->pivotId);
+        cycleStats[dataInfo->pivotId] = (it != m_cycleStats.end()) ? it->second : std::make_shared<CycleStats>();
+    }
+    m_cycleStats.swap(cycleStats);
+}
+
+/**
+ * Open the emission state file for the given cyclic status points, or close it if persistence is disabled
+ *
+ * @param cyclicDataInfos Cyclic status points, in emission state slot order
+ */
+void NotifySystemSp::m_openEmissionState(const std::vector<std::shared_ptr<DataInfo>>& cyclicDataInfos) {
+    if (m_emissionStateFile.empty()) {
+        m_emissionState.close();
+        return;
+    }
+    std::vector<std::pair<std::string, long>> points;
+    points.reserve(cyclicDataInfos.size());
+    for(const auto& dataInfo : cyclicDataInfos) {
+        auto cyclicDataInfo = std::dynamic_pointer_cast<CyclicDataInfo>(dataInfo);
+        points.emplace_back(cyclicDataInfo->pivotId, cyclicDataInfo->cycleMs);
+    }
+    m_emissionState.open(m_emissionStateFile, points);
+}
+
+/**
+ * Get the emission statistics of a cyclic status point
+ *
+ * @param pivotId Pivot ID of the status point
+ * @return Statistics of the status point, or nullptr if it is not a known cyclic status point
  */
-void NotifySystemSp::runCycles(const std::string& messageTemplate, const std::string& pivotId,
-                               const std::string& pivotType, const std::string& assetName, int cycleSec) {
-    long lastMessageTimeMs = 0;
-    long cycleMs = 1000L * cycleSec;
+std::shared_ptr<CycleStats> NotifySystemSp::m_getCycleStats(const std::string& pivotId) const {
+    std::lock_guard<std::mutex> guard(m_cycleStatsMutex);
+    auto it = m_cycleStats.find(pivotId);
+    return (it != m_cycleStats.end()) ? it->second : nullptr;
+}
 
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::runCycles : ";
-    UtilityPivot::log_debug("%s Status Point cycle thread running for %s", beforeLog.c_str(), assetName.c_str());
+/**
+ * Get the emission statistics of a cyclic status point.
+ * Deviations are measured between the ideal deadline of each emission (previous deadline + cycle)
+ * and the time the emission actually happened.
+ *
+ * @param pivotId Pivot ID of the status point
+ * @param snapshot Set to the statistics of the status point
+ * @return True if the status point is a known cyclic status point, else false
+ */
+bool NotifySystemSp::getCycleStats(const std::string& pivotId, CycleStats::Snapshot& snapshot) const {
+    std::shared_ptr<CycleStats> cycleStats = m_getCycleStats(pivotId);
+    if (!cycleStats) {
+        return false;
+    }
+    snapshot = cycleStats->getSnapshot();
+    return true;
+}
 
-    while (m_isRunning) {
-        if (!isEnabled()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-        }
-        // Send the message
-        long currentTimeMs = UtilityPivot::getCurrentTimestampMs();
-        long timeSinceLastSent = currentTimeMs - lastMessageTimeMs;
-        long timeRemaining = cycleMs - timeSinceLastSent;
-        if (timeRemaining <= 0) {
-            // Fill the template with variable values
-            std::string jsonReading = fillTemplate(messageTemplate, pivotId, pivotType, currentTimeMs);
-            if (jsonReading.size() == 0) {
-                return;
-            }
-            // Send a reading with data from the template
-            sendReading(assetName, jsonReading);
-            lastMessageTimeMs = currentTimeMs;
-            timeRemaining = cycleMs;
-        }
-        // Sleep for 1 second or less (avoids waiting for full cycle time when thread is stopping)
-        std::this_thread::sleep_for(std::chrono::milliseconds(std::min(timeRemaining, 1000L)));
+/**
+ * Get the emission statistics of all cyclic status points
+ *
+ * @return Map of statistics indexed by pivot ID
+ */
+std::map<std::string, CycleStats::Snapshot> NotifySystemSp::getAllCycleStats() const {
+    std::lock_guard<std::mutex> guard(m_cycleStatsMutex);
+    std::map<std::string, CycleStats::Snapshot> snapshots;
+    for(const auto& kvp : m_cycleStats) {
+        snapshots[kvp.first] = kvp.second->getSnapshot();
     }
+    return snapshots;
+}
 
-    UtilityPivot::log_debug("%s Status Point cycle thread stopped for %s", beforeLog.c_str(), assetName.c_str());
+/**
+ * Emit a cyclic status point, called by the thread of a scheduler shard when the point is due.
+ * The reading is added to the batch of the shard, ingested once all due points were emitted
+ * or once the batch is full.
+ *
+ * @param shard Scheduler shard of the point
+ * @param point Index of the point in the shard
+ * @param deadlineMs Time at which the point was due
+ * @param nowMs Current time
+ * @param deadlineValid False if the deviation from the deadline must not be recorded
+ * @return False if the point could not be emitted and must not be scheduled anymore
+ */
+bool NotifySystemSp::m_emitCyclic(SchedulerShard& shard, std::size_t point, long deadlineMs, long nowMs,
+                                  bool deadlineValid) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::m_emitCyclic : ";
+    std::size_t slot = shard.points[point];
+    const CyclicPoint& cyclicPoint = m_cyclicPoints[slot];
+    TraceRecorder::Span span("cycleEmission");
+    SYSTEMSPN_PROBE2(cycle_wakeup, cyclicPoint.pivotId.c_str(), nowMs - deadlineMs);
+    // All the points due on a tick share its time, the timestamp is only split once
+    if (nowMs != shard.tickMs) {
+        shard.tickMs = nowMs;
+        shard.tickTime = UtilityPivot::fromTimestamp(nowMs);
+    }
+    // Fill the template with variable values
+    std::string jsonReading = fillTemplate(m_cyclicTemplate, cyclicPoint.pivotId, cyclicPoint.pivotType,
+                                           shard.tickTime);
+    if (jsonReading.size() == 0) {
+        if (m_cyclesLogLimiter.allow(UtilityPivot::LogLevel::Error)) {
+            UtilityPivot::log_error("%s Cycle stopped for %s", beforeLog, cyclicPoint.assetName.c_str());
+        }
+        return false;
+    }
+    // Build a reading with data from the template
+    Reading *reading = m_buildReading(cyclicPoint.assetName, cyclicPoint.pivotId, jsonReading);
+    if (reading == nullptr) {
+        // Already logged and counted as dropped, the point is emitted again on its next cycle
+        return true;
+    }
+    shard.batch.emplace_back(reading);
+    if (deadlineValid && cyclicPoint.cycleStats) {
+        // Recorded when the batch is ingested, so that the deviation includes the time spent ingesting it
+        shard.batchDeadlines.emplace_back(cyclicPoint.cycleStats.get(), deadlineMs);
+    }
+    m_emissionState.setLastEmissionMs(slot, deadlineMs);
+    if (shard.batch.size() >= MaxShardBatch) {
+        m_flushShard(shard);
+    }
+    return true;
 }
 
 /**
@@ -170,17 +383,51 @@ void NotifySystemSp::runCycles(const std::string& messageTemplate, const std::st
  *
  * @param assetName Name of the asset that will contain the reading
  * @param jsonReading Json string representing the reading to send
+ * @param pivotId Pivot ID of the status point, empty for readings of the plugin itself
+ * @return True if the reading was given to the ingest callback, false if it was dropped
+ */
+bool NotifySystemSp::sendReading(const std::string& assetName, const std::string& jsonReading,
+                                 const std::string& pivotId /*= ""*/) {
+    std::unique_ptr<Reading> reading(m_buildReading(assetName, pivotId, jsonReading));
+    return reading && ingest(*reading);
+}
+
+/**
+ * Build the reading of a status point
+ *
+ * @param assetName Name of the asset that will contain the reading
+ * @param pivotId Pivot ID of the status point, empty for readings of the plugin itself
+ * @param jsonReading Json string representing the reading to build
+ * @return Reading owned by the caller, null if the json is invalid
  */
-void NotifySystemSp::sendReading(const std::string& assetName, const std::string& jsonReading) {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::sendReading : ";
-    UtilityPivot::log_debug("%s Creating and sending asset '%s' with reading %s", beforeLog.c_str(), assetName.c_str(), jsonReading.c_str());
+Reading* NotifySystemSp::m_buildReading(const std::string& assetName, const std::string& pivotId,
+                                        const std::string& jsonReading) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::m_buildReading : ";
+    if (m_sendReadingLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+        UtilityPivot::log_debug("%s Creating and sending asset '%s' with reading %s", beforeLog, assetName.c_str(), jsonReading.c_str());
+    }
     // Dummy object used to be able to call parseJson() freely
     static DatapointValue dummyValue("");
     static Datapoint dummyDataPoint({}, dummyValue);
-    // Send the message
-    auto datapoints = dummyDataPoint.parseJson(jsonReading);
-    Reading reading(assetName, *datapoints);
-    ingest(reading);
+    TraceRecorder::Span span("sendReading");
+    Reading *reading = nullptr;
+    {
+        PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::BuildReading);
+        std::vector<Datapoint*>* datapoints = dummyDataPoint.parseJson(jsonReading);
+        if (datapoints != nullptr) {
+            reading = new Reading(assetName, *datapoints);
+            // Datapoints are now owned by the reading, only the vector allocated by parseJson remains to be freed
+            delete datapoints;
+            SYSTEMSPN_PROBE2(reading_built, pivotId.c_str(), timer.elapsedNs());
+        }
+    }
+    if (reading == nullptr) {
+        if (m_sendReadingLogLimiter.allow(UtilityPivot::LogLevel::Error)) {
+            UtilityPivot::log_error("%s Invalid reading json for asset '%s', reading not sent", beforeLog, assetName.c_str());
+        }
+        m_metrics.increment(PerfMetrics::Counter::ReadingsDropped);
+    }
+    return reading;
 }
 
 /**
@@ -194,14 +441,40 @@ void NotifySystemSp::sendReading(const std::string& assetName, const std::string
  */
 std::string NotifySystemSp::fillTemplate(const std::string& messageTemplate, const std::string& pivotId,
                                          const std::string& pivotType, long timestampMs, bool on /*= true*/) const {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - " + pivotId + " - NotifySystemSp::fillTemplate : ";
-    // Fill the template with variable values
-    std::string message = std::regex_replace(messageTemplate, std::regex("<pivot_id>"), pivotId);
-    message = std::regex_replace(message, std::regex("<pivot_type>"), pivotType);
-    auto timePair = UtilityPivot::fromTimestamp(timestampMs);
-    message = std::regex_replace(message, std::regex("<timestamp_sec>"), std::to_string(timePair.first));
-    message = std::regex_replace(message, std::regex("<timestamp_sub_sec>"), std::to_string(timePair.second));
-    std::string value;
+    return fillTemplate(messageTemplate, pivotId, pivotType, UtilityPivot::fromTimestamp(timestampMs), on);
+}
+
+/**
+ * Generate a reading json from a template and values
+ *
+ * @param messageTemplate String containing the template of the reading json message to send
+ * @param pivotId Pivot ID to use in the message
+ * @param pivotType Pivot Type to use in the message
+ * @param timePair Timestamp split in seconds and fraction of second, as returned by UtilityPivot::fromTimestamp
+ * @param on Value of the message (True = 1/"on", False = 0/"off")
+ */
+std::string NotifySystemSp::fillTemplate(const std::string& messageTemplate, const std::string& pivotId,
+                                         const std::string& pivotType, const std::pair<long, long>& timePair,
+                                         bool on /*= true*/) const {
+    return fillTemplate(MessageTemplate(messageTemplate), pivotId, pivotType, timePair, on);
+}
+
+/**
+ * Generate a reading json from a template already split on its placeholders and values
+ *
+ * @param messageTemplate Template of the reading json message to send
+ * @param pivotId Pivot ID to use in the message
+ * @param pivotType Pivot Type to use in the message
+ * @param timePair Timestamp split in seconds and fraction of second, as returned by UtilityPivot::fromTimestamp
+ * @param on Value of the message (True = 1/"on", False = 0/"off")
+ */
+std::string NotifySystemSp::fillTemplate(const MessageTemplate& messageTemplate, const std::string& pivotId,
+                                         const std::string& pivotType, const std::pair<long, long>& timePair,
+                                         bool on /*= true*/) const {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::fillTemplate : ";
+    PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::FillTemplate);
+    TraceRecorder::Span span("fillTemplate");
+    const char *value = nullptr;
     if (pivotType == ConstantsSystem::JsonCdcSps) {
         value = on?"1":"0";
     }
@@ -209,10 +482,12 @@ std::string NotifySystemSp::fillTemplate(const std::string& messageTemplate, con
         value = on?QUOTE("on"):QUOTE("off");
     }
     else {
-        UtilityPivot::log_fatal("%s Invalid pivot type: %s, message not sent", beforeLog.c_str(), pivotType.c_str());
+        UtilityPivot::log_fatal("%s %s - Invalid pivot type: %s, message not sent", beforeLog, pivotId.c_str(), pivotType.c_str());
         return "";
     }
-    message = std::regex_replace(message, std::regex("<value>"), value);
+    // Fill the template with variable values
+    std::string message;
+    messageTemplate.fill(message, pivotId, pivotType, timePair, value);
     return message;
 }
 
@@ -220,15 +495,73 @@ std::string NotifySystemSp::fillTemplate(const std::string& messageTemplate, con
  * Calls the ingest function with the given reading.
  *
  * @param reading Reading to send through ingest
+ * @return False if no ingest callback is registered and the reading was dropped
  */
-void NotifySystemSp::ingest(Reading &reading) {
+bool NotifySystemSp::ingest(Reading &reading) {
     std::lock_guard<std::mutex> guard(m_ingestMutex);
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::ingest : ";
-    if (m_ingest == nullptr) {
-        UtilityPivot::log_error("%s Callback is not defined", beforeLog.c_str());
+    return m_ingestLocked(reading);
+}
+
+/**
+ * Ingest the readings batched by a scheduler shard, count those actually ingested and record
+ * the deviation of their emissions. The clock is read once for the whole batch, after it was ingested.
+ *
+ * @param shard Scheduler shard whose batch is emptied
+ */
+void NotifySystemSp::m_flushShard(SchedulerShard& shard) {
+    if (shard.batch.empty()) {
+        return;
+    }
+    m_metrics.increment(PerfMetrics::Counter::ReadingsAcces, m_ingestBatch(shard.batch));
+    if (shard.batchDeadlines.empty()) {
         return;
     }
+    long ingestedMs = m_clock->nowMs();
+    for (const auto& batchDeadline : shard.batchDeadlines) {
+        batchDeadline.first->record(ingestedMs - batchDeadline.second, m_lateThresholdMs);
+    }
+    shard.batchDeadlines.clear();
+}
+
+/**
+ * Send a batch of readings to the ingest callback, the callback lock is taken once for all of them
+ *
+ * @param readings Readings to send, the batch is emptied
+ * @return Number of readings given to the ingest callback
+ */
+std::size_t NotifySystemSp::m_ingestBatch(std::vector<std::unique_ptr<Reading>>& readings) {
+    std::size_t ingested = 0;
+    {
+        std::lock_guard<std::mutex> guard(m_ingestMutex);
+        for (auto& reading : readings) {
+            if (m_ingestLocked(*reading)) {
+                ingested++;
+            }
+        }
+    }
+    readings.clear();
+    return ingested;
+}
+
+/**
+ * Send a reading to the ingest callback, m_ingestMutex must be held
+ *
+ * @param reading Reading to send
+ * @return False if no ingest callback is registered and the reading was dropped
+ */
+bool NotifySystemSp::m_ingestLocked(Reading &reading) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::ingest : ";
+    if (m_ingest == nullptr) {
+        UtilityPivot::log_error("%s Callback is not defined", beforeLog);
+        m_metrics.increment(PerfMetrics::Counter::ReadingsDropped);
+        return false;
+    }
+    PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::IngestCallback);
+    TraceRecorder::Span span("ingest");
+    SYSTEMSPN_PROBE1(ingest_enter, reading.getAssetName().c_str());
     (*m_ingest)(m_data, &reading);
+    SYSTEMSPN_PROBE2(ingest_exit, reading.getAssetName().c_str(), timer.elapsedNs());
+    return true;
 }
 
 /**
@@ -253,66 +586,422 @@ void NotifySystemSp::registerIngest(FuncPtr ingest, void *data) {
  */
 bool NotifySystemSp::notify(const std::string& /*notificationName*/, const std::string& triggerReason,
                             const std::string& /*message*/) {
+    // Notifications delivered right after plugin_init are handled once the configuration is imported
+    waitForInitialization();
     std::lock_guard<std::mutex> guard(m_configMutex);
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::notify -";
+    m_metrics.increment(PerfMetrics::Counter::NotifyReceived);
+    SYSTEMSPN_PROBE1(notify_received, triggerReason.c_str());
     if (!isEnabled()) {
+        m_metrics.increment(PerfMetrics::Counter::NotifyRejected);
+        SYSTEMSPN_PROBE2(notify_rejected, "", "disabled");
         return false;
     }
 
+    std::string asset;
+    std::string reason;
+    bool parsed = false;
+    {
+        PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::NotifyParse);
+        TraceRecorder::Span span("notifyParse");
+        parsed = m_parseTriggerReason(triggerReason, asset, reason);
+    }
+    bool accepted = false;
+    if (parsed) {
+        PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::NotifyDispatch);
+        TraceRecorder::Span span("notifyDispatch");
+        accepted = m_dispatchNotification(asset, reason, triggerReason);
+        if (accepted) {
+            SYSTEMSPN_PROBE3(notify_dispatched, asset.c_str(), reason.c_str(), timer.elapsedNs());
+        }
+    }
+    if (accepted) {
+        m_metrics.increment(PerfMetrics::Counter::NotifyAccepted);
+    }
+    else {
+        m_metrics.increment(PerfMetrics::Counter::NotifyRejected);
+        SYSTEMSPN_PROBE2(notify_rejected, asset.c_str(), reason.c_str());
+    }
+    return accepted;
+}
+
+/**
+ * Extract asset and reason from the trigger reason of a notification
+ *
+ * @param triggerReason	Json string describing why the notification is being sent
+ * @param asset Set to the asset of the notification
+ * @param reason Set to the reason of the notification
+ * @return True if the trigger reason is valid and its asset is handled by the plugin, else false
+ */
+bool NotifySystemSp::m_parseTriggerReason(const std::string& triggerReason, std::string& asset, std::string& reason) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::notify -";
     // Parse the JSON that represents the reason data
     rapidjson::Document doc;
     doc.Parse(triggerReason.c_str());
     if(doc.HasParseError()) {
-        UtilityPivot::log_error("%s Invalid JSON: %s", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Error)) {
+            UtilityPivot::log_error("%s Invalid JSON: %s", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
 
     if(!doc.HasMember("asset")) {
-        UtilityPivot::log_debug("%s Received notification with no 'asset' attribute, ignoring: %s", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+            UtilityPivot::log_debug("%s Received notification with no 'asset' attribute, ignoring: %s", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
 
     if(!doc["asset"].IsString()) {
-        UtilityPivot::log_debug("%s Received notification with unknown 'asset' type, ignoring: %s", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+            UtilityPivot::log_debug("%s Received notification with unknown 'asset' type, ignoring: %s", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
 
-    std::string asset = doc["asset"].GetString();
+    asset = doc["asset"].GetString();
     if(asset != "prt.inf" && asset != "connx_status" && asset != "gi_status") {
-        UtilityPivot::log_debug("%s Received notification with unhandled 'asset' value, ignoring: %s", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+            UtilityPivot::log_debug("%s Received notification with unhandled 'asset' value, ignoring: %s", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
 
     if(!doc.HasMember("reason")) {
-        UtilityPivot::log_error("%s Received notification with no 'reason' attribute, ignoring: %s", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Error)) {
+            UtilityPivot::log_error("%s Received notification with no 'reason' attribute, ignoring: %s", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
 
     if(!doc["reason"].IsString()) {
-        UtilityPivot::log_error("%s Received notification with unknown 'reason' type, ignoring: %s", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Error)) {
+            UtilityPivot::log_error("%s Received notification with unknown 'reason' type, ignoring: %s", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
 
-    std::string reason = doc["reason"].GetString();
+    reason = doc["reason"].GetString();
+    return true;
+}
+
+/**
+ * Trigger actions for a notification with a handled asset
+ *
+ * @param asset Asset of the notification
+ * @param reason Reason of the notification
+ * @param triggerReason	Json string describing why the notification is being sent, used for logs
+ * @return True if the notification was process sucessfully, else false
+ */
+bool NotifySystemSp::m_dispatchNotification(const std::string& asset, const std::string& reason,
+                                            const std::string& triggerReason) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::notify -";
     if (asset == "gi_status" && reason == "finished"){
-        UtilityPivot::log_debug("%s Received 'gi_status' notification with 'finished' reason, sending reading", beforeLog.c_str());
-       bool ret = sendPrtInfSP(true);
-       ret = ret && sendPrtInfSP(false);
+        m_giTriggersReceived++;
+        long currentTimeMs = m_clock->nowMs();
+        long windowMs = m_giCoalescingWindowMs;
+        if ((windowMs > 0) && (m_lastGiPulseMs > 0) && (currentTimeMs - m_lastGiPulseMs < windowMs)) {
+            m_giTriggersMerged++;
+            if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+                UtilityPivot::log_debug("%s Received 'gi_status' notification with 'finished' reason %ld ms after last pulse, merged into it",
+                                        beforeLog, currentTimeMs - m_lastGiPulseMs);
+            }
+            if (!m_giTrailingPending || !*m_giTrailingPending) {
+                m_scheduleGiTrailingPulse(m_lastGiPulseMs + windowMs);
+            }
+            return true;
+        }
+        // This pulse also signals the triggers merged into a window that ended before its trailing pulse
+        m_cancelGiTrailingPulse();
+        m_lastGiPulseMs = currentTimeMs;
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+            UtilityPivot::log_debug("%s Received 'gi_status' notification with 'finished' reason, sending reading", beforeLog);
+        }
+       bool ret = m_sendPrtInfSP(true);
+       ret = ret && m_sendPrtInfSP(false);
 
        return ret;
     }
     else if(asset == "connx_status"){
-        UtilityPivot::log_debug("%s Received 'connx_status' notification with '%s' reason, ignoring", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+            UtilityPivot::log_debug("%s Received 'connx_status' notification with '%s' reason, ignoring", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
     else {
-        UtilityPivot::log_error("%s Received notification with unhandled 'reason' value, ignoring: %s", beforeLog.c_str(), triggerReason.c_str());
+        if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Error)) {
+            UtilityPivot::log_error("%s Received notification with unhandled 'reason' value, ignoring: %s", beforeLog, triggerReason.c_str());
+        }
         return false;
     }
 
     return true;
 }
 
+/**
+ * Starts the thread sending the trailing pulse of the current coalescing window, m_configMutex must be held
+ *
+ * @param pulseMs Time of the end of the window
+ */
+void NotifySystemSp::m_scheduleGiTrailingPulse(long pulseMs) {
+    m_giTrailingPending = std::make_shared<std::atomic<bool>>(true);
+    m_clock->addParticipant();
+    // The previous thread may still wait for m_configMutex, it is joined by the new one
+    m_giTrailingThread = std::thread(&NotifySystemSp::m_runGiTrailingPulse, this, m_clock, pulseMs,
+                                     m_giTrailingPending, std::move(m_giTrailingThread));
+}
+
+/**
+ * Cancels the trailing pulse not sent yet, m_configMutex must be held
+ */
+void NotifySystemSp::m_cancelGiTrailingPulse() {
+    if (m_giTrailingPending && *m_giTrailingPending) {
+        *m_giTrailingPending = false;
+        m_clock->notifyStop();
+    }
+}
+
+/**
+ * Thread function sending the trailing pulse of a coalescing window, unless it was cancelled
+ *
+ * @param clock Clock of the window
+ * @param pulseMs Time of the end of the window
+ * @param pending Cleared when the pulse is cancelled
+ * @param previous Thread of the previous window, done or cancelled
+ */
+void NotifySystemSp::m_runGiTrailingPulse(std::shared_ptr<Clock> clock, long pulseMs,
+                                          std::shared_ptr<std::atomic<bool>> pending, std::thread previous) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::m_runGiTrailingPulse -";
+    ClockParticipant participant(*clock);
+    if (previous.joinable()) {
+        previous.join();
+    }
+    clock->sleepForMs(pulseMs - clock->nowMs(), *pending);
+    std::lock_guard<std::mutex> guard(m_configMutex);
+    if (!*pending) {
+        return;
+    }
+    *pending = false;
+    if (!isEnabled()) {
+        return;
+    }
+    m_lastGiPulseMs = clock->nowMs();
+    if (m_notifyLogLimiter.allow(UtilityPivot::LogLevel::Debug)) {
+        UtilityPivot::log_debug("%s 'gi_status' notifications merged during the coalescing window, sending reading", beforeLog);
+    }
+    if (m_sendPrtInfSP(true)) {
+        m_sendPrtInfSP(false);
+    }
+}
+
+/**
+ * Starts the thread sending periodically a reading with the plugin own performance counters
+ *
+ * @param assetName Name of the asset of the telemetry readings
+ * @param periodSec Period in seconds between two telemetry readings
+ */
+void NotifySystemSp::startStats(const std::string& assetName, long periodSec) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::startStats :";
+    stopStats();
+    if (assetName.empty() || (periodSec <= 0)) {
+        UtilityPivot::log_debug("%s Telemetry readings disabled", beforeLog);
+        return;
+    }
+    UtilityPivot::log_debug("%s Sending telemetry asset '%s' every %ld s", beforeLog, assetName.c_str(), periodSec);
+    m_statsRunning = true;
+    m_statsThread = std::thread(&NotifySystemSp::m_runStats, this, assetName, periodSec);
+}
+
+/**
+ * Stops the thread sending telemetry readings
+ */
+void NotifySystemSp::stopStats() {
+    {
+        std::lock_guard<std::mutex> guard(m_statsMutex);
+        m_statsRunning = false;
+    }
+    m_statsCond.notify_all();
+    if (m_statsThread.joinable()) {
+        m_statsThread.join();
+    }
+}
+
+/**
+ * Thread function used to send the telemetry readings periodically
+ *
+ * @param assetName Name of the asset of the telemetry readings
+ * @param periodSec Period in seconds between two telemetry readings
+ */
+void NotifySystemSp::m_runStats(const std::string& assetName, long periodSec) {
+    PerfMetrics::Snapshot previous = m_metrics.getSnapshot();
+    long previousTimeMs = UtilityPivot::getCurrentTimestampMs();
+    std::unique_lock<std::mutex> lock(m_statsMutex);
+    while (m_statsRunning) {
+        m_statsCond.wait_for(lock, std::chrono::seconds(periodSec), [this]{ return !m_statsRunning; });
+        if (!m_statsRunning) {
+            break;
+        }
+        lock.unlock();
+        PerfMetrics::Snapshot current = m_metrics.getSnapshot();
+        long currentTimeMs = UtilityPivot::getCurrentTimestampMs();
+        if (isEnabled()) {
+            sendReading(assetName, buildStatsJson(current, previous, currentTimeMs - previousTimeMs));
+        }
+        previous = current;
+        previousTimeMs = currentTimeMs;
+        lock.lock();
+    }
+}
+
+/**
+ * Generate the json of a telemetry reading
+ *
+ * @param current Metrics at the end of the telemetry period
+ * @param previous Metrics at the start of the telemetry period
+ * @param elapsedMs Duration of the telemetry period in ms
+ * @return Json string with one datapoint per telemetry value
+ */
+std::string NotifySystemSp::buildStatsJson(const PerfMetrics::Snapshot& current, const PerfMetrics::Snapshot& previous,
+                                           long elapsedMs) const {
+    const AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+    uint64_t emissions = current.counter(PerfMetrics::Counter::ReadingsAcces) +
+                         current.counter(PerfMetrics::Counter::ReadingsPrtInf);
+    uint64_t notifications = current.counter(PerfMetrics::Counter::NotifyReceived) -
+                             previous.counter(PerfMetrics::Counter::NotifyReceived);
+    double notifyRate = elapsedMs > 0 ? (1000.0 * static_cast<double>(notifications)) / static_cast<double>(elapsedMs) : 0.0;
+    uint64_t ingestP99Us = current.latencyNs(PerfMetrics::Latency::IngestCallback).percentile(99) / 1000;
+
+    std::string json("{");
+    json.append("\"emissions\":").append(std::to_string(emissions));
+    json.append(",\"drops\":").append(std::to_string(current.counter(PerfMetrics::Counter::ReadingsDropped)));
+    json.append(",\"log_queue_depth\":").append(std::to_string(asyncLogger.isActive() ? asyncLogger.getQueuedCount() : 0));
+    json.append(",\"log_drops\":").append(std::to_string(asyncLogger.getDroppedCount()));
+    json.append(",\"ingest_p99_us\":").append(std::to_string(ingestP99Us));
+    json.append(",\"notify_rate\":").append(std::to_string(notifyRate));
+    json.append(",\"threads\":").append(std::to_string(current.cycleThreads + (m_statsRunning ? 1 : 0)));
+    json.append(",\"points\":").append(std::to_string(current.points));
+    json.append("}");
+    return json;
+}
+
+/**
+ * Starts or stops the asynchronous logging backend
+ *
+ * @param enabled True to log asynchronously, false to log from the emitting threads
+ * @param capacityStr Maximum number of log messages waiting to be written, default capacity used if empty
+ */
+void NotifySystemSp::m_configureAsyncLogging(bool enabled, const std::string& capacityStr) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::m_configureAsyncLogging :";
+    long capacity = AsyncLogger::DefaultCapacity;
+    if (enabled && !capacityStr.empty()) {
+        try {
+            capacity = std::stol(capacityStr);
+        }
+        catch (const std::exception&) {
+            capacity = 0;
+        }
+        if (capacity <= 0) {
+            UtilityPivot::log_error("%s Invalid async_logging_capacity: '%s', using default capacity %lu",
+                                    beforeLog, capacityStr.c_str(), AsyncLogger::DefaultCapacity);
+            capacity = AsyncLogger::DefaultCapacity;
+        }
+    }
+    // Restarting the logger would drop the messages it holds, it is only done on an actual change
+    if ((enabled == m_asyncLoggingStarted) && (!enabled || (capacity == m_asyncLoggingCapacity))) {
+        return;
+    }
+    AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+    if (m_asyncLoggingStarted) {
+        // The logger keeps running if another plugin instance of the process uses it
+        asyncLogger.stop();
+        m_asyncLoggingStarted = false;
+    }
+    if (!enabled) {
+        return;
+    }
+    // A logger already started by another plugin instance keeps its capacity
+    asyncLogger.start(capacity);
+    m_asyncLoggingStarted = true;
+    m_asyncLoggingCapacity = capacity;
+}
+
+/**
+ * Starts or stops the recording of spans for Chrome trace / Perfetto
+ *
+ * @param enabled True to record spans, false to stop recording them
+ * @param capacityStr Maximum number of spans kept in memory, default capacity used if empty
+ * @param filePath File where spans are dumped at shutdown, 'systemspn_trace.json' in the Fledge data directory if empty
+ */
+void NotifySystemSp::m_configureTracing(bool enabled, const std::string& capacityStr, const std::string& filePath) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::m_configureTracing :";
+    TraceRecorder& traceRecorder = TraceRecorder::getInstance();
+    m_traceFile = filePath;
+    if (m_traceFile.empty()) {
+        const std::string dataDirectory = UtilityPivot::getDataDirectory();
+        if (!dataDirectory.empty()) {
+            m_traceFile = dataDirectory + "/" FILTER_NAME "_trace.json";
+        }
+        else if (enabled) {
+            UtilityPivot::log_error("%s No trace_file and neither FLEDGE_DATA nor FLEDGE_ROOT is set, tracing disabled",
+                                    beforeLog);
+            enabled = false;
+        }
+    }
+    if (!enabled) {
+        if (m_tracingStarted) {
+            traceRecorder.disable();
+            m_tracingStarted = false;
+        }
+        return;
+    }
+    long capacity = TraceRecorder::DefaultCapacity;
+    if (!capacityStr.empty()) {
+        try {
+            capacity = std::stol(capacityStr);
+        }
+        catch (const std::exception&) {
+            capacity = 0;
+        }
+        if (capacity <= 0) {
+            UtilityPivot::log_error("%s Invalid trace_capacity: '%s', using default capacity %lu",
+                                    beforeLog, capacityStr.c_str(), TraceRecorder::DefaultCapacity);
+            capacity = TraceRecorder::DefaultCapacity;
+        }
+    }
+    // Capacity can only be changed by restarting the recording, which discards recorded spans
+    if (traceRecorder.isEnabled() && traceRecorder.getCapacity() != static_cast<std::size_t>(capacity)) {
+        traceRecorder.disable();
+    }
+    traceRecorder.enable(capacity);
+    m_tracingStarted = true;
+}
+
+/**
+ * Writes the spans recorded so far to a Chrome trace event JSON file
+ *
+ * @param filePath File to write, trace file from the configuration if empty
+ * @return True if the file was written, else false
+ */
+bool NotifySystemSp::dumpTrace(const std::string& filePath /*= ""*/) const {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::dumpTrace :";
+    const std::string& path = filePath.empty() ? m_traceFile : filePath;
+    if (path.empty() || !TraceRecorder::getInstance().dump(path)) {
+        UtilityPivot::log_error("%s Unable to write trace file '%s'", beforeLog, path.c_str());
+        return false;
+    }
+    UtilityPivot::log_info("%s Trace written to '%s'", beforeLog, path.c_str());
+    return true;
+}
+
+/**
+ * Get the number of hot path log messages suppressed by rate limiting since startup
+ *
+ * @return Total number of suppressed log messages
+ */
+unsigned long NotifySystemSp::getSuppressedLogsCount() const {
+    return m_sendReadingLogLimiter.getSuppressedCount() + m_cyclesLogLimiter.getSuppressedCount() +
+           m_notifyLogLimiter.getSuppressedCount();
+}
+
 /**
  * Sends a 'prt.inf' reading with the given value.
  *
@@ -320,23 +1009,42 @@ bool NotifySystemSp::notify(const std::string& /*notificationName*/, const std::
  * @return True if the reading was sent successfully, else false
  */
 bool NotifySystemSp::sendPrtInfSP(bool value) {
-    std::string beforeLog = ConstantsSystem::NamePlugin + " - NotifySystemSp::sendPrtInfSP -";
-    std::string messageTemplate = getMessageTemplate("prt.inf");
-    long currentTimeMs = UtilityPivot::getCurrentTimestampMs();
+    // The configuration must not be replaced by a concurrent reconfigure while it is read
+    waitForInitialization();
+    std::lock_guard<std::mutex> guard(m_configMutex);
+    return m_sendPrtInfSP(value);
+}
+
+/**
+ * Sends a 'prt.inf' reading with the given value, m_configMutex must be held by the caller
+ *
+ * @param value The value to send in the 'prt.inf' reading
+ * @return True if the reading was sent successfully, else false
+ */
+bool NotifySystemSp::m_sendPrtInfSP(bool value) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::sendPrtInfSP -";
+    // All the readings of the call share one timestamp
+    auto currentTime = UtilityPivot::fromTimestamp(m_clock->nowMs());
     const auto& dataSystem = m_configPlugin.getDataSystem();
     bool success = true;
     for(const auto& dataInfo : dataSystem.at("prt.inf")) {
-        std::string jsonReading = fillTemplate(messageTemplate, dataInfo->pivotId, dataInfo->pivotType,
-                                               currentTimeMs, value);
+        std::string jsonReading = fillTemplate(m_prtInfTemplate, dataInfo->pivotId, dataInfo->pivotType,
+                                               currentTime, value);
         if (jsonReading.size() == 0) {
             success = false;
             continue;
         }
         // Send a reading with data from the template
         if(dataInfo->isTransientWarning){
-            UtilityPivot::log_warn("%s sending transient prt.inf without transient subtype in configuration prt.inf always transient", beforeLog.c_str());
+            if (m_sendReadingLogLimiter.allow(UtilityPivot::LogLevel::Warning)) {
+                UtilityPivot::log_warn("%s sending transient prt.inf without transient subtype in configuration prt.inf always transient", beforeLog);
+            }
         }
-        sendReading(dataInfo->assetName, jsonReading);
+        if (!sendReading(dataInfo->assetName, jsonReading, dataInfo->pivotId)) {
+            success = false;
+            continue;
+        }
+        m_metrics.increment(PerfMetrics::Counter::ReadingsPrtInf);
     }
     return success;
 }
@@ -345,7 +1053,7 @@ bool NotifySystemSp::sendPrtInfSP(bool value) {
  * Reconfiguration entry point to the filter.
  *
  * This method runs holding the configMutex to prevent
- * ingest using the regex class that may be destroyed by this
+ * ingest using the templates that may be replaced by this
  * call.
  *
  * Pass the configuration to the base FilterPlugin class and
@@ -355,12 +1063,240 @@ bool NotifySystemSp::sendPrtInfSP(bool value) {
  * @param newConfig  The JSON of the new configuration
  */
 void NotifySystemSp::reconfigure(const ConfigCategory& config) {
+    // A configuration still being imported in background must not be applied after this one
+    waitForInitialization();
     std::lock_guard<std::mutex> guard(m_configMutex);
+    PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::Reconfigure);
+    TraceRecorder::Span span("reconfigure");
+    m_applyConfig(config, true);
+}
+
+/**
+ * Initial configuration of the filter, called by plugin_init.
+ *
+ * When the item background_init is true, only the configuration items are
+ * validated and applied before returning, the import of the exchanged data
+ * and the start of the cycles are done by a background thread.
+ * Until they are finished, notify() and reconfigure() wait for them so that
+ * no early notification is handled with an incomplete configuration.
+ *
+ * @param config  The initial configuration
+ */
+void NotifySystemSp::initialize(const ConfigCategory& config) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::initialize :";
+    // Categories given to reconfigure() have a fixed name, the one of the instance is only known here
+    m_categoryName = config.getName();
+    std::replace(m_categoryName.begin(), m_categoryName.end(), '/', '_');
+    bool backgroundInit = config.itemExists("background_init") &&
+                          (config.getValue("background_init").compare("true") == 0 ||
+                           config.getValue("background_init").compare("True") == 0);
+    if (!backgroundInit || !config.itemExists("exchanged_data") || m_initThread.joinable()) {
+        reconfigure(config);
+        return;
+    }
+    std::lock_guard<std::mutex> guard(m_configMutex);
+    {
+        PerfMetrics::ScopedTimer timer(m_metrics, PerfMetrics::Latency::Reconfigure);
+        TraceRecorder::Span span("reconfigure");
+        m_applyConfig(config, false);
+    }
+    UtilityPivot::log_info("%s Importing exchanged data in background", beforeLog);
+    // Set before the thread is started, so that any call following plugin_init waits for the import
+    m_initPending = true;
+    m_initThread = std::thread(&NotifySystemSp::m_runBackgroundInit, this, config.getValue("exchanged_data"));
+}
+
+/**
+ * Block until the background import started by initialize() is finished
+ */
+void NotifySystemSp::waitForInitialization() {
+    if (!m_initPending) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_initMutex);
+    m_initCond.wait(lock, [this] { return !m_initPending; });
+}
+
+/**
+ * Import the exchanged data and start the cycles, run in background by initialize()
+ *
+ * @param jsonExchanged : configuration ExchangedData
+ */
+void NotifySystemSp::m_runBackgroundInit(const std::string& jsonExchanged) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::m_runBackgroundInit :";
+    {
+        std::lock_guard<std::mutex> guard(m_configMutex);
+        TraceRecorder::Span span("backgroundInit");
+        setJsonConfig(jsonExchanged);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_initMutex);
+        m_initPending = false;
+    }
+    m_initCond.notify_all();
+    UtilityPivot::log_info("%s Exchanged data imported, cycles started", beforeLog);
+}
+
+/**
+ * Apply the configuration items, called holding the configMutex
+ *
+ * @param config  The configuration to apply
+ * @param importExchangedData  False if the item exchanged_data must be ignored
+ */
+void NotifySystemSp::m_applyConfig(const ConfigCategory& config, bool importExchangedData) {
+    constexpr const char *beforeLog = FILTER_NAME " - NotifySystemSp::reconfigure :";
     if (config.itemExists("enable")) {
         m_enabled = config.getValue("enable").compare("true") == 0 ||
                     config.getValue("enable").compare("True") == 0;
+        // Schedulers waiting on their event loop do not poll the enabled flag
+        for(auto& shard : m_shards) {
+            shard->scheduler.wakeUp();
+        }
+    }
+    if (config.itemExists("gi_coalescing_window")) {
+        const std::string& windowStr = config.getValue("gi_coalescing_window");
+        try {
+            long windowMs = std::stol(windowStr);
+            if (windowMs < 0) {
+                UtilityPivot::log_error("%s Negative gi_coalescing_window: %ld, value ignored", beforeLog, windowMs);
+            }
+            else {
+                m_giCoalescingWindowMs = windowMs;
+            }
+        }
+        catch (const std::exception&) {
+            UtilityPivot::log_error("%s Invalid gi_coalescing_window: '%s', value ignored", beforeLog, windowStr.c_str());
+        }
+    }
+    if (config.itemExists("late_emission_threshold")) {
+        const std::string& thresholdStr = config.getValue("late_emission_threshold");
+        try {
+            long thresholdMs = std::stol(thresholdStr);
+            if (thresholdMs < 0) {
+                UtilityPivot::log_error("%s Negative late_emission_threshold: %ld, value ignored", beforeLog, thresholdMs);
+            }
+            else {
+                m_lateThresholdMs = thresholdMs;
+            }
+        }
+        catch (const std::exception&) {
+            UtilityPivot::log_error("%s Invalid late_emission_threshold: '%s', value ignored", beforeLog, thresholdStr.c_str());
+        }
+    }
+    if (config.itemExists("log_rate_limit")) {
+        const std::string& rateStr = config.getValue("log_rate_limit");
+        try {
+            long rate = std::stol(rateStr);
+            if (rate < 0) {
+                UtilityPivot::log_error("%s Negative log_rate_limit: %ld, value ignored", beforeLog, rate);
+            }
+            else {
+                m_sendReadingLogLimiter.setMaxPerPeriod(rate);
+                m_cyclesLogLimiter.setMaxPerPeriod(rate);
+                m_notifyLogLimiter.setMaxPerPeriod(rate);
+            }
+        }
+        catch (const std::exception&) {
+            UtilityPivot::log_error("%s Invalid log_rate_limit: '%s', value ignored", beforeLog, rateStr.c_str());
+        }
+    }
+    if (config.itemExists("async_logging")) {
+        bool asyncLogging = config.getValue("async_logging").compare("true") == 0 ||
+                            config.getValue("async_logging").compare("True") == 0;
+        m_configureAsyncLogging(asyncLogging, config.itemExists("async_logging_capacity") ?
+                                              config.getValue("async_logging_capacity") : "");
+    }
+    if (config.itemExists("trace_enable")) {
+        bool tracing = config.getValue("trace_enable").compare("true") == 0 ||
+                       config.getValue("trace_enable").compare("True") == 0;
+        m_configureTracing(tracing, config.itemExists("trace_capacity") ? config.getValue("trace_capacity") : "",
+                           config.itemExists("trace_file") ? config.getValue("trace_file") : "");
+    }
+    if (config.itemExists("emission_state")) {
+        bool persisted = config.getValue("emission_state").compare("true") == 0 ||
+                         config.getValue("emission_state").compare("True") == 0;
+        m_emissionStateFile = config.itemExists("emission_state_file") ? config.getValue("emission_state_file") : "";
+        if (!persisted) {
+            m_emissionStateFile.clear();
+        }
+        else if (m_emissionStateFile.empty()) {
+            const std::string dataDirectory = UtilityPivot::getDataDirectory();
+            if (dataDirectory.empty()) {
+                UtilityPivot::log_error("%s No emission_state_file and neither FLEDGE_DATA nor FLEDGE_ROOT is set, "
+                                        "emission state not persisted", beforeLog);
+            }
+            else {
+                // One file per instance, an instance cannot open the file of another one
+                m_emissionStateFile = dataDirectory + "/" FILTER_NAME "_" +
+                                      (m_categoryName.empty() ? std::string() : m_categoryName + "_") + "emission.state";
+            }
+        }
     }
-    if (config.itemExists("exchanged_data")) {
+    if (config.itemExists("startup_ramp")) {
+        const std::string& rampStr = config.getValue("startup_ramp");
+        try {
+            long rampMs = std::stol(rampStr);
+            if (rampMs < 0) {
+                UtilityPivot::log_error("%s Negative startup_ramp: %ld, value ignored", beforeLog, rampMs);
+            }
+            else {
+                m_startupRampMs = rampMs;
+            }
+        }
+        catch (const std::exception&) {
+            UtilityPivot::log_error("%s Invalid startup_ramp: '%s', value ignored", beforeLog, rampStr.c_str());
+        }
+    }
+    if (config.itemExists("scheduler_shards")) {
+        const std::string& shardsStr = config.getValue("scheduler_shards");
+        try {
+            long shards = std::stol(shardsStr);
+            if (shards < 1 || shards > static_cast<long>(MaxSchedulerShards)) {
+                UtilityPivot::log_error("%s Invalid scheduler_shards: %ld (1 to %lu expected), value ignored", beforeLog,
+                                        shards, static_cast<unsigned long>(MaxSchedulerShards));
+            }
+            else {
+                m_schedulerShards = static_cast<std::size_t>(shards);
+            }
+        }
+        catch (const std::exception&) {
+            UtilityPivot::log_error("%s Invalid scheduler_shards: '%s', value ignored", beforeLog, shardsStr.c_str());
+        }
+    }
+    if (config.itemExists("scheduler_cpu_affinity")) {
+        m_schedulerAffinity = config.getValue("scheduler_cpu_affinity").compare("true") == 0 ||
+                              config.getValue("scheduler_cpu_affinity").compare("True") == 0;
+    }
+    if (config.itemExists("scheduler_event_loop")) {
+        m_schedulerEventLoop = config.getValue("scheduler_event_loop").compare("true") == 0 ||
+                               config.getValue("scheduler_event_loop").compare("True") == 0;
+    }
+    if (config.itemExists("config_snapshot")) {
+        bool snapshot = config.getValue("config_snapshot").compare("true") == 0 ||
+                        config.getValue("config_snapshot").compare("True") == 0;
+        const std::string dataDirectory = snapshot ? UtilityPivot::getDataDirectory() : "";
+        if (snapshot && dataDirectory.empty()) {
+            UtilityPivot::log_error("%s Neither FLEDGE_DATA nor FLEDGE_ROOT is set, configuration snapshots disabled",
+                                    beforeLog);
+        }
+        m_configPlugin.setSnapshotDirectory(dataDirectory, m_categoryName);
+    }
+    if (importExchangedData && config.itemExists("exchanged_data")) {
         setJsonConfig(config.getValue("exchanged_data"));
     }
+    if (config.itemExists("stats_asset") || config.itemExists("stats_period")) {
+        if (config.itemExists("stats_asset")) {
+            m_statsAsset = config.getValue("stats_asset");
+        }
+        if (config.itemExists("stats_period")) {
+            const std::string& periodStr = config.getValue("stats_period");
+            try {
+                m_statsPeriodSec = std::stol(periodStr);
+            }
+            catch (const std::exception&) {
+                UtilityPivot::log_error("%s Invalid stats_period: '%s', value ignored", beforeLog, periodStr.c_str());
+            }
+        }
+        startStats(m_statsAsset, m_statsPeriodSec);
+    }
 }
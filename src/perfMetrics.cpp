@@ -0,0 +1,344 @@
+/*
+ * Performance metrics of the plugin
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <new>
+
+#include "perfMetrics.h"
+
+using namespace systemspn;
+
+constexpr int LatencyHistogram::SubBucketBits;
+constexpr int LatencyHistogram::MaxPowerOfTwo;
+constexpr int LatencyHistogram::BucketCount;
+constexpr int DeviationHistogram::SubBucketBits;
+constexpr int DeviationHistogram::MaxPowerOfTwo;
+constexpr int DeviationHistogram::BucketCount;
+constexpr int PerfMetrics::CounterCount;
+constexpr int PerfMetrics::LatencyCount;
+constexpr int PerfMetrics::SlotCount;
+constexpr std::size_t PerfMetrics::CacheLineSize;
+
+namespace {
+    /*
+     * Log-linear buckets shared by the histograms: values below 2^(SubBucketBits + 1) have their
+     * own bucket, then each power of 2 is split in 2^SubBucketBits buckets of the same width
+     */
+    template<int SubBucketBits>
+    int logLinearIndex(uint64_t value) {
+        constexpr uint64_t linearLimit = 1ULL << (SubBucketBits + 1);
+        if (value < linearLimit) {
+            return static_cast<int>(value);
+        }
+        int powerOfTwo = 63 - __builtin_clzll(value);
+        int subBucket = static_cast<int>((value >> (powerOfTwo - SubBucketBits)) & ((1 << SubBucketBits) - 1));
+        return static_cast<int>(linearLimit) + (powerOfTwo - SubBucketBits - 1) * (1 << SubBucketBits) + subBucket;
+    }
+
+    template<int SubBucketBits>
+    uint64_t logLinearUpperBound(int index) {
+        constexpr int linearLimit = 1 << (SubBucketBits + 1);
+        if (index < linearLimit) {
+            return static_cast<uint64_t>(index);
+        }
+        int powerOfTwo = (index - linearLimit) / (1 << SubBucketBits) + SubBucketBits + 1;
+        uint64_t subBucket = static_cast<uint64_t>((index - linearLimit) % (1 << SubBucketBits));
+        uint64_t lowerBound = ((1ULL << SubBucketBits) + subBucket) << (powerOfTwo - SubBucketBits);
+        return lowerBound + (1ULL << (powerOfTwo - SubBucketBits)) - 1;
+    }
+}
+
+/**
+ * Records a value in the histogram
+ *
+ * @param value : Value to record
+*/
+void LatencyHistogram::record(uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t currentMax = max.load(std::memory_order_relaxed);
+    while ((value > currentMax) && !max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {}
+}
+
+/**
+ * Get the index of the bucket containing a value
+ *
+ * @param value : Value to look for
+ * @return Index of the bucket, values too large for the histogram are stored in the last one
+*/
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value >> (MaxPowerOfTwo + 1) != 0) {
+        return BucketCount - 1;
+    }
+    return logLinearIndex<SubBucketBits>(value);
+}
+
+/**
+ * Get the highest value stored in a bucket
+ *
+ * @param index : Index of the bucket
+ * @return Highest value of the bucket
+*/
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    return logLinearUpperBound<SubBucketBits>(index);
+}
+
+/**
+ * Adds the content of a histogram to this snapshot
+ *
+ * @param histogram : Histogram to add
+*/
+void HistogramSnapshot::merge(const LatencyHistogram& histogram) {
+    for (int i = 0; i < LatencyHistogram::BucketCount; i++) {
+        buckets[i] += histogram.buckets[i].load(std::memory_order_relaxed);
+    }
+    count += histogram.count.load(std::memory_order_relaxed);
+    sum += histogram.sum.load(std::memory_order_relaxed);
+    uint64_t histogramMax = histogram.max.load(std::memory_order_relaxed);
+    if (histogramMax > max) {
+        max = histogramMax;
+    }
+}
+
+/**
+ * Get the value under which the given percentage of the recorded values are
+ *
+ * @param percent : Percentage between 0 and 100
+ * @return Upper bound of the bucket containing the percentile, never more than the max recorded value
+*/
+uint64_t HistogramSnapshot::percentile(double percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    auto target = static_cast<uint64_t>(percent * static_cast<double>(count) / 100.0 + 0.5);
+    if (target < 1) {
+        target = 1;
+    }
+    uint64_t cumulated = 0;
+    for (int i = 0; i < LatencyHistogram::BucketCount; i++) {
+        cumulated += buckets[i];
+        if (cumulated >= target) {
+            uint64_t upperBound = LatencyHistogram::bucketUpperBound(i);
+            return upperBound < max ? upperBound : max;
+        }
+    }
+    return max;
+}
+
+/**
+ * Records a deviation in the histogram
+ *
+ * @param valueMs : Deviation in ms
+*/
+void DeviationHistogram::record(uint64_t valueMs) {
+    buckets[bucketIndex(valueMs)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    uint64_t currentMax = max.load(std::memory_order_relaxed);
+    while ((valueMs > currentMax) && !max.compare_exchange_weak(currentMax, valueMs, std::memory_order_relaxed)) {}
+}
+
+/**
+ * Get the index of the bucket containing a deviation
+ *
+ * @param valueMs : Deviation in ms
+ * @return Index of the bucket, deviations too long for the histogram are stored in the last one
+*/
+int DeviationHistogram::bucketIndex(uint64_t valueMs) {
+    if (valueMs >> (MaxPowerOfTwo + 1) != 0) {
+        return BucketCount - 1;
+    }
+    return logLinearIndex<SubBucketBits>(valueMs);
+}
+
+/**
+ * Get the longest deviation stored in a bucket
+ *
+ * @param index : Index of the bucket
+ * @return Longest deviation of the bucket in ms
+*/
+uint64_t DeviationHistogram::bucketUpperBound(int index) {
+    if (index >= BucketCount - 1) {
+        return UINT64_MAX;
+    }
+    return logLinearUpperBound<SubBucketBits>(index);
+}
+
+/**
+ * Get the deviation under which the given percentage of the recorded deviations are
+ *
+ * @param percent : Percentage between 0 and 100
+ * @return Upper bound of the bucket containing the percentile, never more than the max recorded deviation
+*/
+uint64_t DeviationHistogram::percentile(double percent) const {
+    std::array<uint64_t, BucketCount> counts;
+    uint64_t total = 0;
+    for (int i = 0; i < BucketCount; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    uint64_t maxMs = max.load(std::memory_order_relaxed);
+    if (total == 0) {
+        return 0;
+    }
+    auto target = static_cast<uint64_t>(percent * static_cast<double>(total) / 100.0 + 0.5);
+    if (target < 1) {
+        target = 1;
+    }
+    uint64_t cumulated = 0;
+    for (int i = 0; i < BucketCount; i++) {
+        cumulated += counts[i];
+        if (cumulated >= target) {
+            uint64_t upperBound = bucketUpperBound(i);
+            return upperBound < maxMs ? upperBound : maxMs;
+        }
+    }
+    return maxMs;
+}
+
+/**
+ * Records the deviation of one emission from its deadline
+ *
+ * @param deviation : Time in ms between the ideal deadline and the actual emission
+ * @param lateThresholdMs : Deviation above which the emission is counted as late
+*/
+void CycleStats::record(long deviation, long lateThresholdMs) {
+    if (deviation < 0) {
+        deviation = 0;
+    }
+    deviationMs.record(static_cast<uint64_t>(deviation));
+    if (deviation > lateThresholdMs) {
+        lateEmissions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Get the statistics of the emissions recorded so far
+ *
+ * @return Snapshot of the statistics
+*/
+CycleStats::Snapshot CycleStats::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.emissions = deviationMs.count.load(std::memory_order_relaxed);
+    snapshot.lateEmissions = lateEmissions.load(std::memory_order_relaxed);
+    snapshot.p50Ms = deviationMs.percentile(50);
+    snapshot.p99Ms = deviationMs.percentile(99);
+    snapshot.maxMs = deviationMs.max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+/**
+ * Constructor
+*/
+PerfMetrics::PerfMetrics() {
+    std::size_t space = sizeof(Slot) * SlotCount + CacheLineSize;
+    m_slotsStorage.reset(new unsigned char[space]);
+    void* storage = m_slotsStorage.get();
+    storage = std::align(CacheLineSize, sizeof(Slot) * SlotCount, storage, space);
+    m_slots = static_cast<Slot*>(storage);
+    for (int i = 0; i < SlotCount; i++) {
+        new (&m_slots[i]) Slot();
+    }
+}
+
+/**
+ * Destructor
+*/
+PerfMetrics::~PerfMetrics() {
+    for (int i = 0; i < SlotCount; i++) {
+        m_slots[i].~Slot();
+    }
+}
+
+/**
+ * Get the slot used by the current thread
+ *
+ * @return Slot in which the current thread records its metrics
+*/
+PerfMetrics::Slot& PerfMetrics::m_getSlot() {
+    static std::atomic<unsigned int> nextSlot{0};
+    static thread_local unsigned int slotIndex = nextSlot++ % SlotCount;
+    return m_slots[slotIndex];
+}
+
+/**
+ * Increments a counter
+ *
+ * @param counterId : Counter to increment
+ * @param value : Value to add to the counter
+*/
+void PerfMetrics::increment(Counter counterId, uint64_t value /*= 1*/) {
+    m_getSlot().counters[static_cast<int>(counterId)].fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * Records a duration in a latency histogram
+ *
+ * @param latencyId : Histogram in which to record the duration
+ * @param durationNs : Duration in ns
+*/
+void PerfMetrics::recordLatency(Latency latencyId, uint64_t durationNs) {
+    m_getSlot().latencies[static_cast<int>(latencyId)].record(durationNs);
+}
+
+/**
+ * Aggregates the metrics recorded by all threads
+ *
+ * @return Snapshot of all metrics
+*/
+PerfMetrics::Snapshot PerfMetrics::getSnapshot() const {
+    Snapshot snapshot;
+    for (int slotIndex = 0; slotIndex < SlotCount; slotIndex++) {
+        const Slot& slot = m_slots[slotIndex];
+        for (int i = 0; i < CounterCount; i++) {
+            snapshot.counters[i] += slot.counters[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < LatencyCount; i++) {
+            snapshot.latenciesNs[i].merge(slot.latencies[i]);
+        }
+    }
+    snapshot.cycleThreads = m_cycleThreads;
+    snapshot.points = m_points;
+    return snapshot;
+}
+
+/**
+ * Get the name of a counter
+ *
+ * @param counterId : Counter
+ * @return Name of the counter
+*/
+const char* PerfMetrics::getCounterName(Counter counterId) {
+    switch (counterId) {
+        case Counter::ReadingsAcces:   return "readings_acces";
+        case Counter::ReadingsPrtInf:  return "readings_prt_inf";
+        case Counter::ReadingsDropped: return "readings_dropped";
+        case Counter::NotifyReceived:  return "notify_received";
+        case Counter::NotifyAccepted:  return "notify_accepted";
+        case Counter::NotifyRejected:  return "notify_rejected";
+        default:                       return "unknown";
+    }
+}
+
+/**
+ * Get the name of a latency histogram
+ *
+ * @param latencyId : Latency histogram
+ * @return Name of the latency histogram
+*/
+const char* PerfMetrics::getLatencyName(Latency latencyId) {
+    switch (latencyId) {
+        case Latency::FillTemplate:   return "fill_template";
+        case Latency::BuildReading:   return "build_reading";
+        case Latency::IngestCallback: return "ingest_callback";
+        case Latency::NotifyParse:    return "notify_parse";
+        case Latency::NotifyDispatch: return "notify_dispatch";
+        case Latency::Reconfigure:    return "reconfigure";
+        case Latency::ConfigImport:   return "config_import";
+        default:                      return "unknown";
+    }
+}
@@ -71,7 +71,133 @@ static const char *default_config = QUOTE({
 					]
 				}
 			})
-   		}
+   		},
+		"gi_coalescing_window" : {
+			"description" : "Time window in milliseconds during which successive 'gi_status' finished notifications are merged into a single prt.inf pulse, followed by a trailing pulse at the end of the window if any was merged (0 disables merging)",
+			"type" : "integer",
+			"displayName" : "GI coalescing window (ms)",
+			"order" : "4",
+			"default" : "0"
+			},
+		"late_emission_threshold" : {
+			"description" : "Delay in milliseconds after its deadline from which a cyclic status point emission is counted as late",
+			"type" : "integer",
+			"displayName" : "Late emission threshold (ms)",
+			"order" : "5",
+			"default" : "100"
+			},
+		"log_rate_limit" : {
+			"description" : "Maximum number of messages logged per second by each hot path (readings emission, cycles, notifications), for debug and info messages and separately for warnings and errors, 0 disables the limit",
+			"type" : "integer",
+			"displayName" : "Log rate limit (msg/s)",
+			"order" : "6",
+			"default" : "100"
+			},
+		"async_logging" : {
+			"description" : "Write logs from a background thread so that slow syslog I/O does not delay emission",
+			"type" : "boolean",
+			"displayName" : "Asynchronous logging",
+			"order" : "7",
+			"default" : "false"
+			},
+		"async_logging_capacity" : {
+			"description" : "Maximum number of log messages waiting to be written when asynchronous logging is enabled, further messages are dropped",
+			"type" : "integer",
+			"displayName" : "Asynchronous logging capacity",
+			"order" : "8",
+			"default" : "1024"
+			},
+		"stats_asset" : {
+			"description" : "Name of the asset of the readings periodically sent with the plugin own performance counters, empty to disable them",
+			"type" : "string",
+			"displayName" : "Telemetry asset name",
+			"order" : "9",
+			"default" : ""
+			},
+		"stats_period" : {
+			"description" : "Period in seconds between two telemetry readings",
+			"type" : "integer",
+			"displayName" : "Telemetry period (s)",
+			"order" : "10",
+			"default" : "60"
+			},
+		"trace_enable" : {
+			"description" : "Record spans of the emission, notification and reconfiguration paths (Chrome trace / Perfetto format)",
+			"type" : "boolean",
+			"displayName" : "Span tracing",
+			"order" : "11",
+			"default" : "false"
+			},
+		"trace_capacity" : {
+			"description" : "Maximum number of spans kept in memory, oldest spans are overwritten",
+			"type" : "integer",
+			"displayName" : "Span tracing capacity",
+			"order" : "12",
+			"default" : "65536"
+			},
+		"trace_file" : {
+			"description" : "File where recorded spans are written at shutdown (Fledge data directory if empty)",
+			"type" : "string",
+			"displayName" : "Span tracing file",
+			"order" : "13",
+			"default" : ""
+			},
+		"background_init" : {
+			"description" : "Return from plugin start once the configuration is validated, import the exchanged data and start the cycles in background",
+			"type" : "boolean",
+			"displayName" : "Background initialization",
+			"order" : "14",
+			"default" : "false"
+			},
+		"config_snapshot" : {
+			"description" : "Keep a binary snapshot of the imported exchanged data in the Fledge data directory, restored instead of parsing the same configuration again",
+			"type" : "boolean",
+			"displayName" : "Configuration snapshot",
+			"order" : "15",
+			"default" : "false"
+			},
+		"emission_state" : {
+			"description" : "Persist the last emission time of each cyclic status point, so that a restart resumes the previous cadence instead of sending all of them at once",
+			"type" : "boolean",
+			"displayName" : "Persist emission times",
+			"order" : "16",
+			"default" : "false"
+			},
+		"emission_state_file" : {
+			"description" : "File where emission times are persisted, only used by this instance (file named after the instance in the Fledge data directory if empty)",
+			"type" : "string",
+			"displayName" : "Emission times file",
+			"order" : "17",
+			"default" : ""
+			},
+		"startup_ramp" : {
+			"description" : "Window (ms) over which the first emissions of cyclic status points are spread in pivot ID order, limited to the cycle of each point (0 sends them all at start)",
+			"type" : "integer",
+			"displayName" : "Startup ramp (ms)",
+			"order" : "18",
+			"default" : "0"
+			},
+		"scheduler_shards" : {
+			"description" : "Number of threads emitting the cyclic status points, points are partitioned by hash of their pivot ID (1 to 64)",
+			"type" : "integer",
+			"displayName" : "Scheduler shards",
+			"order" : "19",
+			"default" : "1"
+			},
+		"scheduler_cpu_affinity" : {
+			"description" : "Bind each scheduler shard to its own CPU",
+			"type" : "boolean",
+			"displayName" : "Scheduler CPU affinity",
+			"order" : "20",
+			"default" : "false"
+			},
+		"scheduler_event_loop" : {
+			"description" : "Scheduler shards wait for the next deadline on a timerfd/epoll event loop instead of sleeping",
+			"type" : "boolean",
+			"displayName" : "Scheduler event loop",
+			"order" : "21",
+			"default" : "true"
+			}
 	});
 
 /**
@@ -113,7 +239,7 @@ PLUGIN_INFORMATION *plugin_info() {
 PLUGIN_HANDLE plugin_init(ConfigCategory* config)
 {
 	auto notifySystemSp = new NotifySystemSp();
- 	notifySystemSp->reconfigure(*config);
+ 	notifySystemSp->initialize(*config);
 	return (PLUGIN_HANDLE)notifySystemSp;
 }
 
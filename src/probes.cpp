@@ -0,0 +1,18 @@
+/*
+ * SDT semaphores of the USDT static probes
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include "probes.h"
+
+#ifdef SYSTEMSPN_USDT
+// Set by the tracer while it is attached to a probe
+#define SYSTEMSPN_PROBE_SEMAPHORE_DEFINITION(name) \
+    unsigned short systemspn_##name##_semaphore __attribute__((unused, section(".probes"))) = 0;
+extern "C" {
+SYSTEMSPN_PROBES(SYSTEMSPN_PROBE_SEMAPHORE_DEFINITION)
+}
+#endif
@@ -0,0 +1,273 @@
+/*
+ * Hierarchical timing wheel of the cyclic status point deadlines
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <algorithm>
+#include <climits>
+
+#include "timingWheel.h"
+
+using namespace systemspn;
+
+constexpr uint32_t TimingWheel::Nil;
+constexpr int      TimingWheel::Levels;
+constexpr uint32_t TimingWheel::FirstLevelSlots;
+constexpr uint32_t TimingWheel::LevelSlots;
+constexpr uint32_t TimingWheel::Slots;
+constexpr int      TimingWheel::LevelShift[TimingWheel::Levels];
+
+namespace {
+    // Deadlines further than this are stored in the last level and cascaded again when reached
+    constexpr long MaxDeltaMs = (1L << 32) - 1;
+
+    uint32_t firstSlotOfLevel(int level) {
+        return level == 0 ? 0 : 256 + static_cast<uint32_t>(level - 1) * 64;
+    }
+}
+
+/**
+ * Remove all entries and set the current time
+ *
+ * @param nowMs Current time, deadlines before it expire on the next call to advance()
+ */
+void TimingWheel::reset(long nowMs) {
+    m_nodes.clear();
+    std::fill(m_heads, m_heads + Slots, Nil);
+    std::fill(m_tails, m_tails + Slots, Nil);
+    std::fill(m_occupied, m_occupied + Slots / 64, 0);
+    m_currentMs = nowMs;
+    m_size = 0;
+}
+
+/**
+ * Schedule an entry, replacing its previous deadline if it is already scheduled
+ *
+ * @param id Index of the entry
+ * @param deadlineMs Deadline of the entry, expires on the next call to advance() if already passed
+ */
+void TimingWheel::schedule(std::size_t id, long deadlineMs) {
+    if (id >= m_nodes.size()) {
+        m_nodes.resize(id + 1);
+    }
+    uint32_t index = static_cast<uint32_t>(id);
+    if (m_nodes[index].slot != Nil) {
+        m_unlink(index);
+    }
+    m_nodes[index].deadlineMs = deadlineMs;
+    m_link(index, m_slotFor(deadlineMs));
+}
+
+/**
+ * Remove an entry, nothing is done if it is not scheduled
+ *
+ * @param id Index of the entry
+ */
+void TimingWheel::cancel(std::size_t id) {
+    if (isScheduled(id)) {
+        m_unlink(static_cast<uint32_t>(id));
+    }
+}
+
+/**
+ * Advance the current time, expired entries are removed from the wheel
+ *
+ * @param nowMs Time to advance to, entries with a deadline up to it included expire
+ * @param expired Expired entries are appended to it, in deadline order between slots and in
+ *                scheduling order within a slot (deadlines already passed when scheduled share
+ *                the slot of the time they were scheduled at)
+ */
+void TimingWheel::advance(long nowMs, std::vector<Expired>& expired) {
+    while (m_currentMs <= nowMs) {
+        uint32_t index = static_cast<uint32_t>(m_currentMs & (FirstLevelSlots - 1));
+        long blockStartMs = m_currentMs - index;
+        long limitMs = std::min(blockStartMs + FirstLevelSlots - 1, nowMs);
+        int slot = m_findFirstLevel(index);
+        if (slot >= 0 && blockStartMs + slot <= limitMs) {
+            m_currentMs = blockStartMs + slot;
+            m_expireSlot(static_cast<uint32_t>(slot), expired);
+        }
+        else {
+            // Nothing due in this block before nowMs
+            m_currentMs = limitMs;
+        }
+        m_currentMs++;
+        if ((m_currentMs & (FirstLevelSlots - 1)) == 0) {
+            m_cascade();
+        }
+    }
+}
+
+/**
+ * Earliest time at which an entry may expire, exact if it is stored in the first level,
+ * otherwise the time of the next cascade that can bring entries to the first level
+ *
+ * @return Time in ms, LONG_MAX if the wheel is empty
+ */
+long TimingWheel::getNextDeadlineMs() const {
+    if (m_size == 0) {
+        return LONG_MAX;
+    }
+    uint32_t index = static_cast<uint32_t>(m_currentMs & (FirstLevelSlots - 1));
+    long blockStartMs = m_currentMs - index;
+    int slot = m_findFirstLevel(index);
+    if (slot >= 0) {
+        return blockStartMs + slot;
+    }
+    // First level slots before the current one belong to the next block
+    long nextMs = LONG_MAX;
+    for (uint32_t word = 0; word < FirstLevelSlots / 64; word++) {
+        if (m_occupied[word] != 0) {
+            nextMs = blockStartMs + FirstLevelSlots;
+            break;
+        }
+    }
+    for (int level = 1; level < Levels; level++) {
+        uint64_t occupied = m_occupied[firstSlotOfLevel(level) / 64];
+        if (occupied == 0) {
+            continue;
+        }
+        int shift = LevelShift[level];
+        long levelIndex = m_currentMs >> shift;
+        uint32_t current = static_cast<uint32_t>(levelIndex & (LevelSlots - 1));
+        // Distance in slots to the next non-empty slot after the current one, the current slot
+        // itself can only hold entries of the next rotation
+        uint64_t rotated = (current == LevelSlots - 1) ? occupied :
+                           (occupied >> (current + 1)) | (occupied << (LevelSlots - 1 - current));
+        long distance = static_cast<long>(__builtin_ctzll(rotated)) + 1;
+        nextMs = std::min(nextMs, (levelIndex + distance) << shift);
+    }
+    return nextMs;
+}
+
+/**
+ * Slot of a deadline relative to the current time
+ */
+uint32_t TimingWheel::m_slotFor(long deadlineMs) const {
+    long effectiveMs = std::max(deadlineMs, m_currentMs);
+    long deltaMs = effectiveMs - m_currentMs;
+    if (deltaMs < static_cast<long>(FirstLevelSlots)) {
+        return static_cast<uint32_t>(effectiveMs & (FirstLevelSlots - 1));
+    }
+    if (deltaMs > MaxDeltaMs) {
+        effectiveMs = m_currentMs + MaxDeltaMs;
+        deltaMs = MaxDeltaMs;
+    }
+    int level = 1;
+    while (level < Levels - 1 && deltaMs >= (1L << (LevelShift[level] + 6))) {
+        level++;
+    }
+    return firstSlotOfLevel(level) + static_cast<uint32_t>((effectiveMs >> LevelShift[level]) & (LevelSlots - 1));
+}
+
+/**
+ * Append an entry to the list of a slot
+ */
+void TimingWheel::m_link(uint32_t id, uint32_t slot) {
+    Node& node = m_nodes[id];
+    node.slot = slot;
+    node.next = Nil;
+    node.prev = m_tails[slot];
+    if (node.prev == Nil) {
+        m_heads[slot] = id;
+        m_occupied[slot / 64] |= 1ULL << (slot % 64);
+    }
+    else {
+        m_nodes[node.prev].next = id;
+    }
+    m_tails[slot] = id;
+    m_size++;
+}
+
+/**
+ * Remove an entry from the list of its slot
+ */
+void TimingWheel::m_unlink(uint32_t id) {
+    Node& node = m_nodes[id];
+    uint32_t slot = node.slot;
+    if (node.prev == Nil) {
+        m_heads[slot] = node.next;
+    }
+    else {
+        m_nodes[node.prev].next = node.next;
+    }
+    if (node.next == Nil) {
+        m_tails[slot] = node.prev;
+    }
+    else {
+        m_nodes[node.next].prev = node.prev;
+    }
+    if (m_heads[slot] == Nil) {
+        m_occupied[slot / 64] &= ~(1ULL << (slot % 64));
+    }
+    node.prev = Nil;
+    node.next = Nil;
+    node.slot = Nil;
+    m_size--;
+}
+
+/**
+ * Remove all entries of a slot, appending them to the expired entries
+ */
+void TimingWheel::m_expireSlot(uint32_t slot, std::vector<Expired>& expired) {
+    uint32_t id = m_heads[slot];
+    while (id != Nil) {
+        Node& node = m_nodes[id];
+        uint32_t next = node.next;
+        expired.push_back({node.deadlineMs, id});
+        node.prev = Nil;
+        node.next = Nil;
+        node.slot = Nil;
+        m_size--;
+        id = next;
+    }
+    m_heads[slot] = Nil;
+    m_tails[slot] = Nil;
+    m_occupied[slot / 64] &= ~(1ULL << (slot % 64));
+}
+
+/**
+ * Move the entries of the slots reached by the current time to the lower levels,
+ * called when the current time enters a new block of the first level
+ */
+void TimingWheel::m_cascade() {
+    // Higher levels first, their entries may land in a lower level slot reached at the same time
+    for (int level = Levels - 1; level > 0; level--) {
+        int shift = LevelShift[level];
+        if ((m_currentMs & ((1L << shift) - 1)) != 0) {
+            continue;
+        }
+        uint32_t slot = firstSlotOfLevel(level) + static_cast<uint32_t>((m_currentMs >> shift) & (LevelSlots - 1));
+        uint32_t id = m_heads[slot];
+        m_heads[slot] = Nil;
+        m_tails[slot] = Nil;
+        m_occupied[slot / 64] &= ~(1ULL << (slot % 64));
+        while (id != Nil) {
+            uint32_t next = m_nodes[id].next;
+            m_size--;
+            m_link(id, m_slotFor(m_nodes[id].deadlineMs));
+            id = next;
+        }
+    }
+}
+
+/**
+ * First non-empty slot of the first level at or after a slot index
+ *
+ * @return Slot index, -1 if none
+ */
+int TimingWheel::m_findFirstLevel(uint32_t from) const {
+    for (uint32_t word = from / 64; word < FirstLevelSlots / 64; word++) {
+        uint64_t occupied = m_occupied[word];
+        if (word == from / 64) {
+            occupied &= ~0ULL << (from % 64);
+        }
+        if (occupied != 0) {
+            return static_cast<int>(word * 64 + __builtin_ctzll(occupied));
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,165 @@
+/*
+ * In-memory recorder of timed spans, exported as Chrome trace events
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+#include "constantsSystem.h"
+#include "traceRecorder.h"
+
+using namespace systemspn;
+
+constexpr std::size_t TraceRecorder::DefaultCapacity;
+
+/**
+ * Get the process wide trace recorder
+ *
+ * @return Reference to the trace recorder
+*/
+TraceRecorder& TraceRecorder::getInstance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+/**
+ * Get a monotonic timestamp in microseconds
+ *
+ * @return Timestamp in us, never 0
+*/
+uint64_t TraceRecorder::nowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count()) + 1;
+}
+
+/**
+ * Get a small identifier of the current thread
+ *
+ * @return Identifier of the thread, unique within the process
+*/
+uint32_t TraceRecorder::m_getThreadId() {
+    static std::atomic<uint32_t> nextThreadId{1};
+    static thread_local uint32_t threadId = nextThreadId++;
+    return threadId;
+}
+
+/**
+ * Allocates the ring of spans and starts recording. Previously recorded spans are discarded.
+ *
+ * @param capacity : Maximum number of spans kept in memory
+*/
+void TraceRecorder::enable(std::size_t capacity /*= DefaultCapacity*/) {
+    std::lock_guard<std::mutex> guard(m_enableMutex);
+    if (m_enabled) {
+        return;
+    }
+    if (capacity == 0) {
+        capacity = DefaultCapacity;
+    }
+    // Spans being recorded by emitting threads must not land in a freed ring
+    while (m_writers > 0) {
+        std::this_thread::yield();
+    }
+    m_events.reset(new Event[capacity]);
+    m_capacity = capacity;
+    m_writeIndex = 0;
+    m_enabled = true;
+}
+
+/**
+ * Stops recording, recorded spans are kept until the next call to enable()
+*/
+void TraceRecorder::disable() {
+    std::lock_guard<std::mutex> guard(m_enableMutex);
+    m_enabled = false;
+    while (m_writers > 0) {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * Records a span, overwriting the oldest one if the ring is full
+ *
+ * @param name : Name of the span, must be a string literal
+ * @param startUs : Start of the span from nowUs()
+ * @param durationUs : Duration of the span in us
+*/
+void TraceRecorder::record(const char *name, uint64_t startUs, uint64_t durationUs) {
+    m_writers++;
+    if (!m_enabled) {
+        m_writers--;
+        return;
+    }
+    uint64_t index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Event& event = m_events[index % m_capacity];
+    // Odd sequence while the event is written, so that dump() skips it
+    event.sequence.store(2 * index + 1, std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.startUs.store(startUs, std::memory_order_relaxed);
+    event.durationUs.store(durationUs, std::memory_order_relaxed);
+    event.threadId.store(m_getThreadId(), std::memory_order_relaxed);
+    event.sequence.store(2 * index + 2, std::memory_order_release);
+    m_writers--;
+}
+
+/**
+ * Get the number of spans currently available in the ring
+ *
+ * @return Number of spans
+*/
+std::size_t TraceRecorder::getRecordedCount() const {
+    std::lock_guard<std::mutex> guard(m_enableMutex);
+    uint64_t written = m_writeIndex;
+    return static_cast<std::size_t>(written < m_capacity ? written : m_capacity);
+}
+
+/**
+ * Get the maximum number of spans kept in memory
+ *
+ * @return Capacity of the ring, 0 if tracing was never enabled
+*/
+std::size_t TraceRecorder::getCapacity() const {
+    std::lock_guard<std::mutex> guard(m_enableMutex);
+    return m_capacity;
+}
+
+/**
+ * Writes all the spans available in the ring to a Chrome trace event JSON file
+ *
+ * @param filePath : Path of the file to write
+ * @return True if the file was written, else false
+*/
+bool TraceRecorder::dump(const std::string& filePath) const {
+    std::lock_guard<std::mutex> guard(m_enableMutex);
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    uint64_t written = m_writeIndex;
+    uint64_t firstIndex = written > m_capacity ? written - m_capacity : 0;
+    for (uint64_t index = firstIndex; index < written; index++) {
+        const Event& event = m_events[index % m_capacity];
+        uint64_t sequence = event.sequence.load(std::memory_order_acquire);
+        const char *name = event.name.load(std::memory_order_relaxed);
+        uint64_t startUs = event.startUs.load(std::memory_order_relaxed);
+        uint64_t durationUs = event.durationUs.load(std::memory_order_relaxed);
+        uint32_t threadId = event.threadId.load(std::memory_order_relaxed);
+        // Skip events being written or already overwritten by a more recent one
+        if ((sequence != 2 * index + 2) || (event.sequence.load(std::memory_order_acquire) != sequence)) {
+            continue;
+        }
+        file << (first ? "" : ",") << "\n{\"name\":\"" << name << "\",\"cat\":\"" FILTER_NAME "\",\"ph\":\"X\",\"ts\":"
+             << startUs << ",\"dur\":" << durationUs << ",\"pid\":" << getpid() << ",\"tid\":" << threadId << "}";
+        first = false;
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
@@ -8,14 +8,48 @@
  * Author: Yannick Marchetaux
  * 
  */
-#include <cmath>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 #include "utilityPivot.h"
 
 using namespace systemspn;
 
+namespace {
+    // FractionOfSecond of each ms of a second, in units of 1/2^24 s rounded down
+    struct FractionTable {
+        FractionTable() {
+            for (uint32_t ms = 0; ms < 1000; ms++) {
+                fractions[ms] = ms * 16777 + (ms * 216) / 1000;
+            }
+        }
+        uint32_t fractions[1000];
+    };
+    const FractionTable fractionTable;
+
+    // Two digits of each number from 0 to 99
+    constexpr char DigitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    constexpr uint64_t PowersOfTen[] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+        1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+        1000000000000000000ULL, 10000000000000000000ULL
+    };
+
+    // Number of decimal digits of a value, from its number of bits (1233 / 4096 ~ log10(2))
+    int countDigits(uint64_t value) {
+        int digits = ((64 - __builtin_clzll(value | 1)) * 1233) >> 12;
+        return digits + 1 - ((value | 1) < PowersOfTen[digits]);
+    }
+}
+
 /**
  * Convert secondSinceEpoch and secondSinceEpoch to timestamp
  * @param secondSinceEpoch : interval in seconds continuously counted from the epoch 1970-01-01 00:00:00 UTC
@@ -23,10 +57,7 @@ using namespace systemspn;
  * @return timestamp (ms)
 */
 long UtilityPivot::toTimestamp(long secondSinceEpoch, long fractionOfSecond) {
-    long timestamp = 0;
-    auto msPart = (long)round((double)(fractionOfSecond * 1000) / 16777216.0);
-    timestamp = (secondSinceEpoch * 1000L) + msPart;
-    return timestamp;
+    return (secondSinceEpoch * 1000L) + fractionToMs(fractionOfSecond);
 }
 
 /**
@@ -35,9 +66,52 @@ long UtilityPivot::toTimestamp(long secondSinceEpoch, long fractionOfSecond) {
  * @return pair of secondSinceEpoch and fractionOfSecond
 */
 std::pair<long, long> UtilityPivot::fromTimestamp(long timestamp) {
-    long remainder = (timestamp % 1000L);
-    long fractionOfSecond = remainder * 16777 + ((remainder * 216) / 1000);
-    return std::make_pair(timestamp / 1000L, fractionOfSecond);
+    return std::make_pair(timestamp / 1000L, msToFraction(timestamp % 1000L));
+}
+
+/**
+ * Convert a number of ms within a second to a fractionOfSecond, read from a precomputed table
+ * @param ms : ms part of a timestamp, from -999 to 999 (negative for timestamps before the epoch)
+ * @return fractionOfSecond in units of 1/2^24 s, rounded toward zero
+*/
+long UtilityPivot::msToFraction(long ms) {
+    return ms < 0 ? -static_cast<long>(fractionTable.fractions[-ms]) : static_cast<long>(fractionTable.fractions[ms]);
+}
+
+/**
+ * Convert a fractionOfSecond to a number of ms, exact inverse of msToFraction
+ * @param fractionOfSecond : fraction of second in units of 1/2^24 s
+ * @return ms rounded to the nearest, halves away from zero
+*/
+long UtilityPivot::fractionToMs(long fractionOfSecond) {
+    long magnitude = fractionOfSecond < 0 ? -fractionOfSecond : fractionOfSecond;
+    long ms = (magnitude * 1000 + (1L << 23)) >> 24;
+    return fractionOfSecond < 0 ? -ms : ms;
+}
+
+/**
+ * Format an integer in decimal, two digits at a time from the end
+ * @param value : value to format
+ * @param buffer : destination, at least IntegerBufferSize characters
+ * @return pointer past the last character written
+*/
+char* UtilityPivot::formatInteger(long value, char *buffer) {
+    *buffer = '-';
+    buffer += value < 0;
+    // Computed in unsigned arithmetic so that LONG_MIN has a magnitude
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    char *end = buffer + countDigits(magnitude);
+    char *position = end;
+    while (magnitude >= 100) {
+        position -= 2;
+        std::memcpy(position, DigitPairs + 2 * (magnitude % 100), 2);
+        magnitude /= 100;
+    }
+    // One or two digits left: with one, both writes store the second digit of its pair
+    long left = position - buffer;
+    buffer[left - 1] = DigitPairs[2 * magnitude + 1];
+    buffer[0] = DigitPairs[2 * magnitude + 2 - left];
+    return end;
 }
 
 /**
@@ -48,6 +122,48 @@ long UtilityPivot::getCurrentTimestampMs() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+/**
+ * Get the directory where the plugin stores its files, resolved as Fledge does:
+ * FLEDGE_DATA if it is set, else the data directory of FLEDGE_ROOT
+ * @return Fledge data directory, or an empty string if neither FLEDGE_DATA nor FLEDGE_ROOT is set
+*/
+std::string UtilityPivot::getDataDirectory() {
+    const char *dataDir = getenv("FLEDGE_DATA");
+    if (dataDir && *dataDir) {
+        return dataDir;
+    }
+    const char *rootDir = getenv("FLEDGE_ROOT");
+    if (rootDir && *rootDir) {
+        return std::string(rootDir) + "/data";
+    }
+    return "";
+}
+
+/**
+ * Tells if a message of the given level would be output by the Fledge logger
+ * The level configured in the logger is one of the Fledge minimum level names:
+ * "debug", "info", "warning", "error" or "critical"
+ * @param level : level of the message to log
+ * @return True if the message should be logged, else false
+*/
+bool UtilityPivot::isLogLevelEnabled(LogLevel level) {
+    const std::string& minLevel = Logger::getLogger()->getMinLevel();
+    LogLevel minLogLevel = LogLevel::Warning;
+    if (minLevel == "debug") {
+        minLogLevel = LogLevel::Debug;
+    }
+    else if (minLevel == "info") {
+        minLogLevel = LogLevel::Info;
+    }
+    else if (minLevel == "error") {
+        minLogLevel = LogLevel::Error;
+    }
+    else if (minLevel == "critical") {
+        minLogLevel = LogLevel::Fatal;
+    }
+    return level >= minLogLevel;
+}
+
 /**
  * Join a list of strings into a single string with the given separator
  * @param list : List of strings to join
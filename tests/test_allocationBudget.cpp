@@ -0,0 +1,212 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <plugin_api.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "notifySystemSp.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+extern "C" {
+	PLUGIN_INFORMATION *plugin_info();
+	PLUGIN_HANDLE plugin_init(ConfigCategory *config);
+    void plugin_reconfigure(PLUGIN_HANDLE *handle, const std::string& newConfig);
+    bool plugin_deliver(PLUGIN_HANDLE handle,
+                    const std::string& deliveryName,
+                    const std::string& notificationName,
+                    const std::string& triggerReason,
+                    const std::string& message);
+    void plugin_registerIngest(PLUGIN_HANDLE *handle, void *func, void *data);
+    void plugin_shutdown(PLUGIN_HANDLE *handle);
+};
+
+// Allocations of all threads are counted while a path is measured, cyclic emissions run on the scheduler thread
+static std::atomic<bool> countAllocations{false};
+static std::atomic<long> allocations{0};
+static std::atomic<long> deallocations{0};
+
+void* operator new(std::size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocations++;
+    }
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (countAllocations.load(std::memory_order_relaxed) && ptr) {
+        deallocations++;
+    }
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+/*
+ * Maximum number of heap allocations of each path: the count measured by the tests below (kept as
+ * a property of each test in the --gtest_output report) plus a margin of about 10% (at least 2), for allocation differences between standard library versions.
+ * Most of them come from the parsing of the reading json by Fledge (Datapoint::parseJson).
+ * Lower them when a path allocates less, so that the improvement cannot regress unnoticed.
+ */
+static constexpr long CyclicEmissionBudget = 245;   // Measured: 221
+static constexpr long PrtInfPulseBudget = 480;      // Measured: 438, two readings
+static constexpr long NotifyRejectedBudget = 5;     // Measured: 3
+
+static std::string configure = QUOTE({
+    "enable" :{
+        "value": "true"
+    },
+    "exchanged_data": {
+        "value" : {
+            "exchanged_data": {
+                "datapoints" : [
+                    {
+                        "label":"TS-1",
+                        "pivot_id":"M_2367_3_15_4",
+                        "pivot_type":"SpsTyp",
+                        "pivot_subtypes": ["prt.inf", "transient"],
+                        "protocols":[]
+                    }
+                ]
+            }
+        }
+    }
+});
+
+class TestAllocationBudget : public testing::Test
+{
+protected:
+    NotifySystemSp *filter = nullptr;
+    std::string previousLevel;
+
+    void SetUp() override
+    {
+        // Logs are not part of the measured paths
+        previousLevel = Logger::getLogger()->getMinLevel();
+        Logger::getLogger()->setMinLevel("error");
+        PLUGIN_INFORMATION *info = plugin_info();
+        ConfigCategory config("systemsp", info->config);
+        config.setItemsValueFromDefault();
+        filter = static_cast<NotifySystemSp *>(plugin_init(&config));
+        plugin_registerIngest(reinterpret_cast<PLUGIN_HANDLE*>(filter), (void*)ingestCallback, nullptr);
+        plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), configure);
+        ASSERT_TRUE(filter->isEnabled());
+    }
+
+    void TearDown() override
+    {
+        plugin_shutdown(reinterpret_cast<PLUGIN_HANDLE*>(filter));
+        Logger::getLogger()->setMinLevel(previousLevel);
+    }
+
+    // Readings are dropped right away, a real ingest copies what it keeps
+    static void ingestCallback(void */*data*/, void */*readingPtr*/) {}
+
+    // Runs a path twice to initialize static data, then counts the allocations of a third run
+    template<class Function>
+    static void measure(Function path, long& allocated, long& freed) {
+        path();
+        path();
+        allocations = 0;
+        deallocations = 0;
+        countAllocations = true;
+        path();
+        countAllocations = false;
+        allocated = allocations;
+        freed = deallocations;
+    }
+};
+
+TEST_F(TestAllocationBudget, CyclicEmission)
+{
+    static std::string cyclicConfig = QUOTE({
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {
+                            "label":"TS-1",
+                            "pivot_id":"M_2367_3_15_4",
+                            "pivot_type":"SpsTyp",
+                            "pivot_subtypes": ["acces"],
+                            "ts_syst_cycle": 1,
+                            "protocols":[]
+                        }
+                    ]
+                }
+            }
+        }
+    });
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    filter->setClock(clock);
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), cyclicConfig);
+    ASSERT_TRUE(clock->waitForSleepers());
+    long allocated = 0;
+    long freed = 0;
+    // One tick of the scheduler: the point is emitted and ingested, then the thread sleeps until the next cycle
+    measure([&clock]() {
+        ASSERT_TRUE(clock->advance(1000));
+    }, allocated, freed);
+    RecordProperty("cyclic_emission_allocations", std::to_string(allocated));
+    ASSERT_EQ(filter->getMetrics().counter(PerfMetrics::Counter::ReadingsAcces), 4);
+    ASSERT_GT(allocated, 0);
+    ASSERT_LE(allocated, CyclicEmissionBudget);
+    // Everything allocated to build and send the reading is freed
+    ASSERT_EQ(allocated, freed);
+    filter->stopCycles();
+}
+
+TEST_F(TestAllocationBudget, PrtInfPulse)
+{
+    long allocated = 0;
+    long freed = 0;
+    measure([this]() {
+        filter->sendPrtInfSP(true);
+        filter->sendPrtInfSP(false);
+    }, allocated, freed);
+    RecordProperty("prtinf_pulse_allocations", std::to_string(allocated));
+    ASSERT_LE(allocated, PrtInfPulseBudget);
+    ASSERT_EQ(allocated, freed);
+}
+
+TEST_F(TestAllocationBudget, Notify)
+{
+    const std::string notifGiFinished = QUOTE({"asset": "gi_status", "reason": "finished"});
+    long allocated = 0;
+    long freed = 0;
+    measure([this, &notifGiFinished]() {
+        filter->notify("notification", notifGiFinished, "message");
+    }, allocated, freed);
+    RecordProperty("notify_gi_finished_allocations", std::to_string(allocated));
+    // Parsing the trigger reason and dispatching come on top of the prt.inf pulse
+    ASSERT_LE(allocated, PrtInfPulseBudget + NotifyRejectedBudget);
+    ASSERT_EQ(allocated, freed);
+
+    const std::string notifUnhandled = QUOTE({"asset": "other_asset", "reason": "finished"});
+    measure([this, &notifUnhandled]() {
+        filter->notify("notification", notifUnhandled, "message");
+    }, allocated, freed);
+    RecordProperty("notify_unhandled_allocations", std::to_string(allocated));
+    ASSERT_LE(allocated, NotifyRejectedBudget);
+    ASSERT_EQ(allocated, freed);
+}
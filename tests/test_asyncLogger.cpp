@@ -0,0 +1,103 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "asyncLogger.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+class TestAsyncLogger : public testing::Test
+{
+protected:
+    std::string previousLevel;
+
+    void SetUp() override
+    {
+        previousLevel = Logger::getLogger()->getMinLevel();
+        Logger::getLogger()->setMinLevel("debug");
+    }
+
+    void TearDown() override
+    {
+        AsyncLogger::getInstance().stop();
+        Logger::getLogger()->setMinLevel(previousLevel);
+    }
+};
+
+TEST_F(TestAsyncLogger, InactiveByDefault)
+{
+    AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+    ASSERT_FALSE(asyncLogger.isActive());
+    ASSERT_FALSE(asyncLogger.push(UtilityPivot::LogLevel::Info, "not queued"));
+    ASSERT_FALSE(UtilityPivot::log_async(UtilityPivot::LogLevel::Info, "not queued %d", 1));
+}
+
+TEST_F(TestAsyncLogger, OverflowAccounting)
+{
+    AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+    unsigned long droppedBefore = asyncLogger.getDroppedCount();
+    unsigned long flushedBefore = asyncLogger.getFlushedCount();
+    // Long flush period so that nothing is consumed before stop()
+    asyncLogger.start(8, 60000);
+    ASSERT_TRUE(asyncLogger.isActive());
+    ASSERT_EQ(asyncLogger.getCapacity(), 8);
+
+    for (int i = 0; i < 20; i++) {
+        UtilityPivot::log_info("Async message %d", i);
+    }
+    ASSERT_EQ(asyncLogger.getQueuedCount(), 8);
+    ASSERT_EQ(asyncLogger.getDroppedCount() - droppedBefore, 12);
+
+    asyncLogger.stop();
+    ASSERT_FALSE(asyncLogger.isActive());
+    ASSERT_EQ(asyncLogger.getQueuedCount(), 0);
+    ASSERT_EQ(asyncLogger.getFlushedCount() - flushedBefore, 8);
+}
+
+TEST_F(TestAsyncLogger, ConcurrentProducers)
+{
+    AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+    unsigned long droppedBefore = asyncLogger.getDroppedCount();
+    unsigned long flushedBefore = asyncLogger.getFlushedCount();
+    asyncLogger.start(64, 1);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 500; i++) {
+                UtilityPivot::log_debug("Thread %d message %d", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    asyncLogger.stop();
+
+    // Every message was either written or accounted as dropped
+    ASSERT_EQ((asyncLogger.getFlushedCount() - flushedBefore) + (asyncLogger.getDroppedCount() - droppedBefore), 2000);
+}
+
+TEST_F(TestAsyncLogger, SharedBetweenUsers)
+{
+    AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+    asyncLogger.start(8, 60000);
+    // Already started: only counted as a new user, with the capacity of the running logger
+    asyncLogger.start(64, 60000);
+    ASSERT_EQ(asyncLogger.getUsers(), 2);
+    ASSERT_EQ(asyncLogger.getCapacity(), 8);
+    UtilityPivot::log_info("Queued message");
+    ASSERT_EQ(asyncLogger.getQueuedCount(), 1);
+
+    asyncLogger.stop();
+    ASSERT_TRUE(asyncLogger.isActive());
+    ASSERT_EQ(asyncLogger.getQueuedCount(), 1);
+    asyncLogger.stop();
+    ASSERT_FALSE(asyncLogger.isActive());
+    ASSERT_EQ(asyncLogger.getUsers(), 0);
+    // Not matched by any start
+    asyncLogger.stop();
+    ASSERT_EQ(asyncLogger.getUsers(), 0);
+}
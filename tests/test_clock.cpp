@@ -0,0 +1,108 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+
+using namespace systemspn;
+
+TEST(TestClock, SystemClock)
+{
+    SystemClock clock;
+    std::atomic<bool> running{true};
+    long before = clock.nowMs();
+    clock.sleepForMs(20, running);
+    ASSERT_GE(clock.nowMs() - before, 20);
+}
+
+TEST(TestClock, SystemClockStop)
+{
+    SystemClock clock;
+    std::atomic<bool> running{true};
+    auto start = std::chrono::steady_clock::now();
+    std::thread thread([&clock, &running]() {
+        clock.sleepForMs(60000, running);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    running = false;
+    clock.notifyStop();
+    thread.join();
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(TestClock, VirtualClockWakesInDeadlineOrder)
+{
+    VirtualClock clock(1000);
+    std::atomic<bool> running{true};
+    std::mutex wakeupsMutex;
+    std::vector<std::pair<int, long>> wakeups;
+    std::vector<std::thread> threads;
+    // Each thread sleeps 3 times its own period
+    for (int period : {300, 200, 500}) {
+        clock.addParticipant();
+        threads.emplace_back([&clock, &running, &wakeupsMutex, &wakeups, period]() {
+            ClockParticipant participant(clock);
+            for (int i = 0; i < 3; i++) {
+                clock.sleepForMs(period, running);
+                std::lock_guard<std::mutex> guard(wakeupsMutex);
+                wakeups.emplace_back(period, clock.nowMs());
+            }
+        });
+    }
+    ASSERT_TRUE(clock.waitForSleepers());
+    ASSERT_EQ(clock.getSleepers(), 3);
+    ASSERT_EQ(clock.nowMs(), 1000);
+
+    ASSERT_TRUE(clock.advance(550));
+    ASSERT_EQ(clock.nowMs(), 1550);
+    {
+        std::lock_guard<std::mutex> guard(wakeupsMutex);
+        ASSERT_EQ(wakeups.size(), 4);
+        ASSERT_EQ(wakeups[0], std::make_pair(200, 1200L));
+        ASSERT_EQ(wakeups[1], std::make_pair(300, 1300L));
+        ASSERT_EQ(wakeups[2], std::make_pair(200, 1400L));
+        ASSERT_EQ(wakeups[3], std::make_pair(500, 1500L));
+    }
+
+    ASSERT_TRUE(clock.advance(1000));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(clock.getParticipants(), 0);
+    ASSERT_EQ(wakeups.size(), 9);
+    ASSERT_EQ(wakeups.back(), std::make_pair(500, 2500L));
+}
+
+TEST(TestClock, VirtualClockStop)
+{
+    VirtualClock clock;
+    std::atomic<bool> running{true};
+    clock.addParticipant();
+    std::thread thread([&clock, &running]() {
+        ClockParticipant participant(clock);
+        while (running) {
+            clock.sleepForMs(1000000, running);
+        }
+    });
+    ASSERT_TRUE(clock.waitForSleepers());
+    running = false;
+    clock.notifyStop();
+    thread.join();
+    ASSERT_EQ(clock.getParticipants(), 0);
+    ASSERT_EQ(clock.getSleepers(), 0);
+    // No participant left, time moves freely
+    ASSERT_TRUE(clock.advance(5000));
+    ASSERT_EQ(clock.nowMs(), 5000);
+}
+
+TEST(TestClock, VirtualClockSettleTimeout)
+{
+    VirtualClock clock;
+    // Participant declared but never sleeping
+    clock.addParticipant();
+    ASSERT_FALSE(clock.advance(1000, 50));
+    clock.removeParticipant();
+    ASSERT_TRUE(clock.advance(1000, 50));
+}
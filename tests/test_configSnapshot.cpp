@@ -0,0 +1,243 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <plugin_api.h>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+#include "configPlugin.h"
+#include "configSnapshot.h"
+
+using namespace systemspn;
+
+static std::string exchangedData = QUOTE({
+    "exchanged_data": {
+        "datapoints" : [
+            {
+                "label":"TS-1",
+                "pivot_id":"M_2367_3_15_4",
+                "pivot_type":"SpsTyp",
+                "pivot_subtypes": ["acces"],
+                "ts_syst_cycle": 30,
+                "protocols":[]
+            },
+            {
+                "label":"TS-2",
+                "pivot_id":"M_2367_3_15_5",
+                "pivot_type":"DpsTyp",
+                "pivot_subtypes": ["prt.inf", "transient"],
+                "protocols":[]
+            },
+            {
+                "label":"TS-3",
+                "pivot_id":"M_2367_3_15_6",
+                "pivot_type":"SpsTyp",
+                "pivot_subtypes": ["prt.inf"],
+                "protocols":[]
+            }
+        ]
+    }
+});
+
+class TestConfigSnapshot : public testing::Test
+{
+protected:
+    std::string directory;
+
+    void SetUp() override
+    {
+        char pattern[] = "/tmp/systemspn_snapshotXXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        directory = pattern;
+    }
+
+    void TearDown() override
+    {
+        ASSERT_EQ(system(("rm -rf " + directory).c_str()), 0);
+    }
+
+    static bool fileExists(const std::string& path) {
+        return access(path.c_str(), F_OK) == 0;
+    }
+
+    static void assertSameDataSystem(const ConfigPlugin& expected, const ConfigPlugin& actual) {
+        ASSERT_EQ(expected.getDataSystem().size(), actual.getDataSystem().size());
+        for (const auto& dataTypeInfos : expected.getDataSystem()) {
+            const auto& actualInfos = actual.getDataSystem().at(dataTypeInfos.first);
+            ASSERT_EQ(dataTypeInfos.second.size(), actualInfos.size());
+            for (size_t i = 0; i < actualInfos.size(); i++) {
+                const auto& expectedInfo = dataTypeInfos.second[i];
+                const auto& actualInfo = actualInfos[i];
+                ASSERT_EQ(expectedInfo->pivotId, actualInfo->pivotId);
+                ASSERT_EQ(expectedInfo->pivotType, actualInfo->pivotType);
+                ASSERT_EQ(expectedInfo->assetName, actualInfo->assetName);
+                ASSERT_EQ(expectedInfo->isTransientWarning, actualInfo->isTransientWarning);
+                auto expectedCyclic = std::dynamic_pointer_cast<CyclicDataInfo>(expectedInfo);
+                auto actualCyclic = std::dynamic_pointer_cast<CyclicDataInfo>(actualInfo);
+                ASSERT_EQ(expectedCyclic == nullptr, actualCyclic == nullptr);
+                if (expectedCyclic) {
+                    ASSERT_EQ(expectedCyclic->cycleMs, actualCyclic->cycleMs);
+                }
+            }
+        }
+    }
+};
+
+TEST_F(TestConfigSnapshot, WriteAndRestore)
+{
+    ConfigPlugin parsed;
+    parsed.setSnapshotDirectory(directory);
+    parsed.importExchangedData(exchangedData);
+    ASSERT_FALSE(parsed.isLoadedFromSnapshot());
+    std::string path = ConfigSnapshot::getPath(directory, "", ConfigSnapshot::hash(exchangedData));
+    ASSERT_TRUE(fileExists(path));
+
+    ConfigPlugin restored;
+    restored.setSnapshotDirectory(directory);
+    restored.importExchangedData(exchangedData);
+    ASSERT_TRUE(restored.isLoadedFromSnapshot());
+    assertSameDataSystem(parsed, restored);
+    ASSERT_EQ(restored.getDataSystem().at("acces").size(), 1u);
+    ASSERT_EQ(restored.getDataSystem().at("prt.inf").size(), 2u);
+    ASSERT_TRUE(restored.hasDataForType("prt.inf", "M_2367_3_15_6"));
+}
+
+TEST_F(TestConfigSnapshot, DisabledWithoutDirectory)
+{
+    ConfigPlugin configPlugin;
+    configPlugin.importExchangedData(exchangedData);
+    configPlugin.importExchangedData(exchangedData);
+    ASSERT_FALSE(configPlugin.isLoadedFromSnapshot());
+    ASSERT_EQ(configPlugin.getDataSystem().at("prt.inf").size(), 2u);
+}
+
+TEST_F(TestConfigSnapshot, NewConfigurationReplacesSnapshot)
+{
+    std::string otherData = exchangedData;
+    otherData.replace(otherData.find("TS-1"), 4, "TS-9");
+    ConfigPlugin configPlugin;
+    configPlugin.setSnapshotDirectory(directory);
+    configPlugin.importExchangedData(exchangedData);
+    configPlugin.importExchangedData(otherData);
+    ASSERT_FALSE(configPlugin.isLoadedFromSnapshot());
+    ASSERT_EQ(configPlugin.getDataSystem().at("acces")[0]->assetName, "TS-9");
+    ASSERT_FALSE(fileExists(ConfigSnapshot::getPath(directory, "", ConfigSnapshot::hash(exchangedData))));
+    ASSERT_TRUE(fileExists(ConfigSnapshot::getPath(directory, "", ConfigSnapshot::hash(otherData))));
+
+    configPlugin.importExchangedData(otherData);
+    ASSERT_TRUE(configPlugin.isLoadedFromSnapshot());
+    ASSERT_EQ(configPlugin.getDataSystem().at("acces")[0]->assetName, "TS-9");
+}
+
+TEST_F(TestConfigSnapshot, StaleSnapshotsOfInstanceAreRemoved)
+{
+    std::string otherData = exchangedData;
+    otherData.replace(otherData.find("TS-1"), 4, "TS-9");
+    std::string thirdData = exchangedData;
+    thirdData.replace(thirdData.find("TS-1"), 4, "TS-8");
+    // Snapshots left by a previous run of the instance and by other instances
+    {
+        ConfigPlugin previousRun;
+        previousRun.setSnapshotDirectory(directory, "delivery");
+        previousRun.importExchangedData(otherData);
+        ConfigPlugin otherInstance;
+        otherInstance.setSnapshotDirectory(directory, "delivery_2");
+        otherInstance.importExchangedData(otherData);
+        ConfigPlugin unnamed;
+        unnamed.setSnapshotDirectory(directory);
+        unnamed.importExchangedData(otherData);
+    }
+    ASSERT_TRUE(fileExists(ConfigSnapshot::getPath(directory, "delivery", ConfigSnapshot::hash(otherData))));
+
+    ConfigPlugin configPlugin;
+    configPlugin.setSnapshotDirectory(directory, "delivery");
+    configPlugin.importExchangedData(exchangedData);
+    ASSERT_TRUE(fileExists(ConfigSnapshot::getPath(directory, "delivery", ConfigSnapshot::hash(exchangedData))));
+    ASSERT_FALSE(fileExists(ConfigSnapshot::getPath(directory, "delivery", ConfigSnapshot::hash(otherData))));
+    ASSERT_TRUE(fileExists(ConfigSnapshot::getPath(directory, "delivery_2", ConfigSnapshot::hash(otherData))));
+    ASSERT_TRUE(fileExists(ConfigSnapshot::getPath(directory, "", ConfigSnapshot::hash(otherData))));
+
+    // Also removed when the current configuration is restored from its snapshot
+    ASSERT_TRUE(ConfigSnapshot::write(ConfigSnapshot::getPath(directory, "delivery", ConfigSnapshot::hash(thirdData)),
+                                      ConfigSnapshot::hash(thirdData), thirdData.size(), configPlugin.getDataSystem()));
+    configPlugin.importExchangedData(exchangedData);
+    ASSERT_TRUE(configPlugin.isLoadedFromSnapshot());
+    ASSERT_FALSE(fileExists(ConfigSnapshot::getPath(directory, "delivery", ConfigSnapshot::hash(thirdData))));
+    ASSERT_EQ(ConfigSnapshot::removeOthers(directory, "delivery",
+                                           ConfigSnapshot::getPath(directory, "delivery", ConfigSnapshot::hash(exchangedData))), 0);
+}
+
+TEST_F(TestConfigSnapshot, CorruptedSnapshotIsIgnored)
+{
+    ConfigPlugin parsed;
+    parsed.setSnapshotDirectory(directory);
+    parsed.importExchangedData(exchangedData);
+    std::string path = ConfigSnapshot::getPath(directory, "", ConfigSnapshot::hash(exchangedData));
+
+    // Truncated file
+    ASSERT_EQ(truncate(path.c_str(), 40), 0);
+    ConfigPlugin restored;
+    restored.setSnapshotDirectory(directory);
+    restored.importExchangedData(exchangedData);
+    ASSERT_FALSE(restored.isLoadedFromSnapshot());
+    assertSameDataSystem(parsed, restored);
+
+    // The snapshot was written again by the import
+    restored.importExchangedData(exchangedData);
+    ASSERT_TRUE(restored.isLoadedFromSnapshot());
+
+    // Snapshot of another configuration under the expected name
+    std::string otherData = exchangedData;
+    otherData.replace(otherData.find("TS-1"), 4, "TS-9");
+    ASSERT_TRUE(ConfigSnapshot::write(path, ConfigSnapshot::hash(otherData), otherData.size(), parsed.getDataSystem()));
+    restored.importExchangedData(exchangedData);
+    ASSERT_FALSE(restored.isLoadedFromSnapshot());
+    assertSameDataSystem(parsed, restored);
+}
+
+TEST_F(TestConfigSnapshot, ConcurrentWritesDoNotShareTemporaryFile)
+{
+    ConfigPlugin parsed;
+    parsed.importExchangedData(exchangedData);
+    const uint64_t hash = ConfigSnapshot::hash(exchangedData);
+    const std::string path = ConfigSnapshot::getPath(directory, "", hash);
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; i++) {
+        writers.emplace_back([&]() {
+            for (int j = 0; j < 50; j++) {
+                ASSERT_TRUE(ConfigSnapshot::write(path, hash, exchangedData.size(), parsed.getDataSystem()));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    ConfigSnapshot::DataSystem restored;
+    ASSERT_TRUE(ConfigSnapshot::load(path, hash, exchangedData.size(), restored));
+
+    // No temporary file is left next to the snapshot
+    int files = 0;
+    DIR *dir = opendir(directory.c_str());
+    ASSERT_NE(dir, nullptr);
+    while (const struct dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            files++;
+        }
+    }
+    closedir(dir);
+    ASSERT_EQ(files, 1);
+}
+
+TEST_F(TestConfigSnapshot, InvalidConfigurationIsNotSaved)
+{
+    std::string invalidData = "{\"exchanged_data\": [";
+    ConfigPlugin configPlugin;
+    configPlugin.setSnapshotDirectory(directory);
+    configPlugin.importExchangedData(invalidData);
+    ASSERT_FALSE(configPlugin.isLoadedFromSnapshot());
+    ASSERT_FALSE(fileExists(ConfigSnapshot::getPath(directory, "", ConfigSnapshot::hash(invalidData))));
+    ASSERT_EQ(configPlugin.getDataSystem().at("acces").size(), 0u);
+}
@@ -684,6 +684,62 @@ TEST_F(TestPluginConfigure, ConfigureErrorCycleNotInt)
     }
 }
 
+TEST_F(TestPluginConfigure, ConfigureCycleMs)
+{
+	std::string configureCycleMs = QUOTE({
+        "exchanged_data": {
+            "datapoints" : [
+                {
+                    "label":"TS-1",
+                    "pivot_id":"M_2367_3_15_4",
+                    "pivot_type":"SpsTyp",
+                    "pivot_subtypes": ["acces"],
+                    "ts_syst_cycle_ms":250,
+                    "ts_syst_cycle":30,
+                    "protocols":[]
+                },
+                {
+                    "label":"TS-2",
+                    "pivot_id":"M_2367_3_15_5",
+                    "pivot_type":"SpsTyp",
+                    "pivot_subtypes": ["acces"],
+                    "ts_syst_cycle_ms":0,
+                    "protocols":[]
+                },
+                {
+                    "label":"TS-3",
+                    "pivot_id":"M_2367_3_15_6",
+                    "pivot_type":"SpsTyp",
+                    "pivot_subtypes": ["acces"],
+                    "ts_syst_cycle":-5,
+                    "protocols":[]
+                },
+                {
+                    "label":"TS-4",
+                    "pivot_id":"M_2367_3_15_7",
+                    "pivot_type":"SpsTyp",
+                    "pivot_subtypes": ["acces"],
+                    "ts_syst_cycle_ms":"250",
+                    "ts_syst_cycle":30,
+                    "protocols":[]
+                }
+            ]
+        }
+    });
+
+    filter->setJsonConfig(configureCycleMs);
+    const auto& dataSystem = filter->getConfigPlugin().getDataSystem();
+    // Points with a null or negative cycle are ignored, as well as points with an invalid
+    // ts_syst_cycle_ms, which does not fall back to ts_syst_cycle
+    ASSERT_EQ(dataSystem.at("acces").size(), 1);
+    auto cyclicDataInfo = std::dynamic_pointer_cast<CyclicDataInfo>(dataSystem.at("acces").at(0));
+    ASSERT_NE(cyclicDataInfo, nullptr);
+    ASSERT_EQ(cyclicDataInfo->pivotId, "M_2367_3_15_4");
+    // ts_syst_cycle_ms takes precedence over ts_syst_cycle
+    ASSERT_EQ(cyclicDataInfo->cycleMs, 250);
+    ASSERT_EQ(cyclicDataInfo->cycleSec, 0);
+}
+
 TEST_F(TestPluginConfigure, ConfigureOKSps)
 {
 	filter->setJsonConfig(configureOKSps);
@@ -717,6 +773,8 @@ TEST_F(TestPluginConfigure, ConfigureOKSps)
                 auto cyclicDataInfo = std::dynamic_pointer_cast<CyclicDataInfo>(dataInfo);
                 ASSERT_EQ(cyclicDataInfo->cycleSec, 30)
                     << "Unexpected cycle seconds " << cyclicDataInfo->cycleSec << " for type " << dataType;
+                ASSERT_EQ(cyclicDataInfo->cycleMs, 30000)
+                    << "Unexpected cycle milliseconds " << cyclicDataInfo->cycleMs << " for type " << dataType;
             }
         }
     }
@@ -755,6 +813,8 @@ TEST_F(TestPluginConfigure, ConfigureOKDps)
                 auto cyclicDataInfo = std::dynamic_pointer_cast<CyclicDataInfo>(dataInfo);
                 ASSERT_EQ(cyclicDataInfo->cycleSec, 30)
                     << "Unexpected cycle seconds " << cyclicDataInfo->cycleSec << " for type " << dataType;
+                ASSERT_EQ(cyclicDataInfo->cycleMs, 30000)
+                    << "Unexpected cycle milliseconds " << cyclicDataInfo->cycleMs << " for type " << dataType;
             }
         }
     }
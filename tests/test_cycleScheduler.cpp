@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "cycleScheduler.h"
+
+using namespace systemspn;
+
+namespace {
+    // Time moves forward by 1 ms on each read, so that any extra read during a tick is visible
+    class TickingClock : public Clock {
+    public:
+        long nowMs() override { return m_nowMs++; }
+        void sleepForMs(long durationMs, const std::atomic<bool>& running) override {
+            if (durationMs > 0) {
+                m_nowMs += durationMs;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+    private:
+        std::atomic<long> m_nowMs{0};
+    };
+}
+
+TEST(TestCycleScheduler, OneClockSamplePerTick)
+{
+    const std::size_t pointsCount = 50;
+    // All points due on the first tick, then not before an hour
+    std::vector<CycleScheduler::Point> points(pointsCount, {3600000, 0});
+    std::mutex mutex;
+    std::vector<long> emissionTimes;
+    std::vector<std::size_t> emissionsAtFlush;
+    std::atomic<bool> enabled{true};
+
+    CycleScheduler::Options options;
+    options.flush = [&]() {
+        std::lock_guard<std::mutex> guard(mutex);
+        emissionsAtFlush.push_back(emissionTimes.size());
+    };
+    CycleScheduler scheduler;
+    scheduler.start(std::make_shared<TickingClock>(), points,
+                    [&](std::size_t point, long deadlineMs, long nowMs, bool deadlineValid) {
+                        std::lock_guard<std::mutex> guard(mutex);
+                        emissionTimes.push_back(nowMs);
+                        return true;
+                    }, enabled, options);
+    for (int i = 0; i < 500; i++) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (!emissionsAtFlush.empty()) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    scheduler.stop();
+
+    ASSERT_EQ(emissionTimes.size(), pointsCount);
+    for (long timeMs : emissionTimes) {
+        ASSERT_EQ(timeMs, emissionTimes.front());
+    }
+    // One flush for the whole tick
+    ASSERT_EQ(emissionsAtFlush, std::vector<std::size_t>({pointsCount}));
+}
+
+TEST(TestCycleScheduler, PhaseKeptAfterStall)
+{
+    auto clock = std::make_shared<VirtualClock>(0);
+    std::vector<CycleScheduler::Point> points = {{1000, 0}};
+    std::vector<long> deadlines;
+    std::vector<long> emissionTimes;
+    std::atomic<bool> enabled{true};
+    std::atomic<bool> running{true};
+
+    CycleScheduler scheduler;
+    scheduler.start(clock, points,
+                    [&](std::size_t point, long deadlineMs, long nowMs, bool deadlineValid) {
+                        deadlines.push_back(deadlineMs);
+                        emissionTimes.push_back(nowMs);
+                        if (deadlineMs == 1000) {
+                            // The emission blocks the scheduler over several cycles
+                            clock->sleepForMs(3500, running);
+                        }
+                        return true;
+                    }, enabled, CycleScheduler::Options());
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_TRUE(clock->advance(8000));
+    scheduler.stop();
+
+    // Deadline 2000 is emitted late once, 3000 and 4000 are skipped and the next ones keep the phase of the cadence
+    ASSERT_EQ(deadlines, std::vector<long>({0, 1000, 2000, 5000, 6000, 7000, 8000}));
+    ASSERT_EQ(emissionTimes, std::vector<long>({0, 1000, 4500, 5000, 6000, 7000, 8000}));
+}
@@ -0,0 +1,96 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+#include "emissionState.h"
+
+using namespace systemspn;
+
+static const std::string stateFile = "test_emissionState.state";
+
+TEST(TestEmissionState, ResumeLastEmission)
+{
+    // Unknown, invalid or future emission times: emit immediately
+    ASSERT_EQ(EmissionState::resumeLastEmission(0, 30000, 100000), 0);
+    ASSERT_EQ(EmissionState::resumeLastEmission(50000, 0, 100000), 0);
+    ASSERT_EQ(EmissionState::resumeLastEmission(150000, 30000, 100000), 0);
+    // Restart within the cycle: next emission one cycle after the last one
+    ASSERT_EQ(EmissionState::resumeLastEmission(90000, 30000, 100000), 90000);
+    ASSERT_EQ(EmissionState::resumeLastEmission(100000, 30000, 100000), 100000);
+    // Slot falling exactly now is due
+    ASSERT_EQ(EmissionState::resumeLastEmission(70000, 30000, 100000), 70000);
+    // Restart after several cycles: the phase of the previous cadence is kept
+    ASSERT_EQ(EmissionState::resumeLastEmission(10000, 30000, 100000), 70000);
+    ASSERT_EQ(EmissionState::resumeLastEmission(10000, 30000, 100001), 100000);
+}
+
+TEST(TestEmissionState, PersistAndRestore)
+{
+    std::remove(stateFile.c_str());
+    {
+        EmissionState state;
+        ASSERT_TRUE(state.open(stateFile, {{"M_1", 30000}, {"M_2", 10000}, {"M_3", 5000}}));
+        ASSERT_TRUE(state.isOpen());
+        ASSERT_EQ(state.getSlotCount(), 3u);
+        ASSERT_EQ(state.getLastEmissionMs(0), 0);
+        state.setLastEmissionMs(0, 1000);
+        state.setLastEmissionMs(1, 2000);
+        state.setLastEmissionMs(2, 3000);
+        // Out of range slots are ignored
+        state.setLastEmissionMs(3, 4000);
+        ASSERT_EQ(state.getLastEmissionMs(3), 0);
+    }
+    {
+        // Points are reordered, M_3 has a new cycle, M_4 is new
+        EmissionState state;
+        ASSERT_TRUE(state.open(stateFile, {{"M_4", 30000}, {"M_2", 10000}, {"M_3", 6000}, {"M_1", 30000}}));
+        ASSERT_EQ(state.getSlotCount(), 4u);
+        ASSERT_EQ(state.getLastEmissionMs(0), 0);
+        ASSERT_EQ(state.getLastEmissionMs(1), 2000);
+        ASSERT_EQ(state.getLastEmissionMs(2), 0);
+        ASSERT_EQ(state.getLastEmissionMs(3), 1000);
+        state.close();
+        ASSERT_FALSE(state.isOpen());
+        ASSERT_EQ(state.getLastEmissionMs(1), 0);
+    }
+    std::remove(stateFile.c_str());
+}
+
+TEST(TestEmissionState, InvalidFile)
+{
+    {
+        std::ofstream file(stateFile, std::ios::out | std::ios::trunc);
+        file << "not an emission state file";
+    }
+    EmissionState state;
+    ASSERT_TRUE(state.open(stateFile, {{"M_1", 30000}}));
+    ASSERT_EQ(state.getLastEmissionMs(0), 0);
+    state.close();
+
+    ASSERT_FALSE(state.open("/nonexistent_directory/state", {{"M_1", 30000}}));
+    ASSERT_FALSE(state.isOpen());
+    std::remove(stateFile.c_str());
+}
+
+TEST(TestEmissionState, LockedFile)
+{
+    std::remove(stateFile.c_str());
+    EmissionState state;
+    ASSERT_TRUE(state.open(stateFile, {{"M_1", 30000}}));
+    state.setLastEmissionMs(0, 1000);
+    // A second instance would truncate the file mapped by the first one
+    EmissionState other;
+    ASSERT_FALSE(other.open(stateFile, {{"M_2", 30000}, {"M_3", 30000}}));
+    ASSERT_FALSE(other.isOpen());
+    state.setLastEmissionMs(0, 2000);
+    ASSERT_EQ(state.getLastEmissionMs(0), 2000);
+    // Reopening by the same instance releases its lock first
+    ASSERT_TRUE(state.open(stateFile, {{"M_1", 30000}}));
+    ASSERT_EQ(state.getLastEmissionMs(0), 2000);
+    state.close();
+    ASSERT_TRUE(other.open(stateFile, {{"M_1", 30000}}));
+    ASSERT_EQ(other.getLastEmissionMs(0), 2000);
+    other.close();
+    std::remove(stateFile.c_str());
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <thread>
+
+#include "eventLoop.h"
+#include "utilityPivot.h"
+
+using namespace systemspn;
+
+TEST(TestEventLoop, WaitUntilDeadline)
+{
+    EventLoop loop;
+    ASSERT_FALSE(loop.isOpen());
+    ASSERT_FALSE(loop.waitUntilMs(0));
+    ASSERT_TRUE(loop.open());
+    ASSERT_TRUE(loop.isOpen());
+
+    // Passed deadline returns at once
+    ASSERT_TRUE(loop.waitUntilMs(UtilityPivot::getCurrentTimestampMs() - 1000));
+
+    long deadlineMs = UtilityPivot::getCurrentTimestampMs() + 50;
+    ASSERT_TRUE(loop.waitUntilMs(deadlineMs));
+    ASSERT_GE(UtilityPivot::getCurrentTimestampMs(), deadlineMs);
+    loop.close();
+    ASSERT_FALSE(loop.isOpen());
+}
+
+TEST(TestEventLoop, WakeInterruptsWait)
+{
+    EventLoop loop;
+    ASSERT_TRUE(loop.open());
+    // A wake-up sent before the wait makes it return immediately
+    loop.wake();
+    ASSERT_FALSE(loop.waitUntilMs(LONG_MAX));
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread waker([&loop]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        loop.wake();
+    });
+    ASSERT_FALSE(loop.waitUntilMs(LONG_MAX));
+    waker.join();
+    long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_GE(elapsedMs, 40);
+    ASSERT_LT(elapsedMs, 5000);
+}
@@ -0,0 +1,107 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "logRateLimiter.h"
+
+using namespace systemspn;
+
+class TestLogRateLimiter : public testing::Test
+{
+protected:
+    std::string previousLevel;
+
+    void SetUp() override
+    {
+        previousLevel = Logger::getLogger()->getMinLevel();
+        Logger::getLogger()->setMinLevel("debug");
+    }
+
+    void TearDown() override
+    {
+        Logger::getLogger()->setMinLevel(previousLevel);
+    }
+};
+
+TEST_F(TestLogRateLimiter, Unlimited)
+{
+    LogRateLimiter limiter("test");
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(limiter.allow(UtilityPivot::LogLevel::Debug));
+    }
+    ASSERT_EQ(limiter.getSuppressedCount(), 0);
+}
+
+TEST_F(TestLogRateLimiter, LimitPerPeriod)
+{
+    LogRateLimiter limiter("test", 5, 200);
+    int allowed = 0;
+    for (int i = 0; i < 20; i++) {
+        if (limiter.allow(UtilityPivot::LogLevel::Debug)) {
+            allowed++;
+        }
+    }
+    ASSERT_EQ(allowed, 5);
+    ASSERT_EQ(limiter.getSuppressedCount(), 15);
+
+    // A new budget is available in the next period
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    ASSERT_TRUE(limiter.allow(UtilityPivot::LogLevel::Debug));
+    ASSERT_EQ(limiter.getSuppressedCount(), 15);
+
+    limiter.setMaxPerPeriod(0);
+    ASSERT_TRUE(limiter.allow(UtilityPivot::LogLevel::Debug));
+}
+
+TEST_F(TestLogRateLimiter, FilteredLevelDoesNotConsumeBudget)
+{
+    LogRateLimiter limiter("test", 1, 10000);
+    Logger::getLogger()->setMinLevel("warning");
+    for (int i = 0; i < 10; i++) {
+        ASSERT_FALSE(limiter.allow(UtilityPivot::LogLevel::Debug));
+    }
+    ASSERT_EQ(limiter.getSuppressedCount(), 0);
+    ASSERT_TRUE(limiter.allow(UtilityPivot::LogLevel::Error));
+    ASSERT_FALSE(limiter.allow(UtilityPivot::LogLevel::Error));
+    ASSERT_EQ(limiter.getSuppressedCount(), 1);
+}
+
+TEST_F(TestLogRateLimiter, SevereMessagesHaveTheirOwnBudget)
+{
+    LogRateLimiter limiter("test", 5, 10000);
+    for (int i = 0; i < 20; i++) {
+        limiter.allow(UtilityPivot::LogLevel::Debug);
+    }
+    ASSERT_FALSE(limiter.allow(UtilityPivot::LogLevel::Info));
+    ASSERT_EQ(limiter.getSuppressedCount(), 16);
+    // A debug flood does not hide warnings and errors
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(limiter.allow(i % 2 ? UtilityPivot::LogLevel::Warning : UtilityPivot::LogLevel::Error));
+    }
+    ASSERT_FALSE(limiter.allow(UtilityPivot::LogLevel::Error));
+    ASSERT_EQ(limiter.getSuppressedCount(), 17);
+}
+
+TEST_F(TestLogRateLimiter, SummaryAtEndOfPeriod)
+{
+    LogRateLimiter limiter("test", 1, 100);
+    ASSERT_TRUE(limiter.allow(UtilityPivot::LogLevel::Debug));
+    ASSERT_FALSE(limiter.allow(UtilityPivot::LogLevel::Debug));
+    ASSERT_TRUE(limiter.allow(UtilityPivot::LogLevel::Error));
+    ASSERT_FALSE(limiter.allow(UtilityPivot::LogLevel::Error));
+    ASSERT_EQ(limiter.getUnreportedCount(), 2);
+    // Reported once the period is over, without any new message
+    for (int i = 0; i < 100 && limiter.getUnreportedCount() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(limiter.getUnreportedCount(), 0);
+    ASSERT_EQ(limiter.getSuppressedCount(), 2);
+
+    // Later bursts are reported as well
+    ASSERT_TRUE(limiter.allow(UtilityPivot::LogLevel::Warning));
+    ASSERT_FALSE(limiter.allow(UtilityPivot::LogLevel::Warning));
+    for (int i = 0; i < 100 && limiter.getUnreportedCount() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(limiter.getUnreportedCount(), 0);
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "messageTemplate.h"
+
+using namespace systemspn;
+
+TEST(TestMessageTemplate, Fill)
+{
+    MessageTemplate messageTemplate(R"({"id":"<pivot_id>","<pivot_type>":{"v":<value>,"s":<timestamp_sec>,"f":<timestamp_sub_sec>}})");
+    ASSERT_FALSE(messageTemplate.empty());
+    std::string message = "previous content";
+    messageTemplate.fill(message, "M_1", "SpsTyp", {1700000000, 8388608}, "1");
+    ASSERT_EQ(message, R"({"id":"M_1","SpsTyp":{"v":1,"s":1700000000,"f":8388608}})");
+    messageTemplate.fill(message, "M_2", "DpsTyp", {0, 0}, R"("off")");
+    ASSERT_EQ(message, R"({"id":"M_2","DpsTyp":{"v":"off","s":0,"f":0}})");
+}
+
+TEST(TestMessageTemplate, OtherText)
+{
+    // Repeated placeholders, unknown ones and lone brackets
+    MessageTemplate messageTemplate("<pivot_id><pivot_id> <other> a<b <pivot_type");
+    std::string message;
+    messageTemplate.fill(message, "M_1", "SpsTyp", {1, 2}, "0");
+    ASSERT_EQ(message, "M_1M_1 <other> a<b <pivot_type");
+
+    MessageTemplate noPlaceholder("no placeholder");
+    noPlaceholder.fill(message, "M_1", "SpsTyp", {1, 2}, "0");
+    ASSERT_EQ(message, "no placeholder");
+
+    MessageTemplate emptyTemplate("");
+    ASSERT_TRUE(emptyTemplate.empty());
+    emptyTemplate.fill(message, "M_1", "SpsTyp", {1, 2}, "0");
+    ASSERT_EQ(message, "");
+}
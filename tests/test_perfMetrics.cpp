@@ -0,0 +1,142 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "perfMetrics.h"
+
+using namespace systemspn;
+
+TEST(TestPerfMetrics, HistogramBuckets)
+{
+    // Small values have their own bucket
+    for (uint64_t value = 0; value < 8; value++) {
+        ASSERT_EQ(LatencyHistogram::bucketIndex(value), static_cast<int>(value));
+        ASSERT_EQ(LatencyHistogram::bucketUpperBound(static_cast<int>(value)), value);
+    }
+    // Each bucket contains all values up to its upper bound, and the next value opens the next bucket
+    for (int index = 0; index < LatencyHistogram::BucketCount - 1; index++) {
+        uint64_t upperBound = LatencyHistogram::bucketUpperBound(index);
+        ASSERT_EQ(LatencyHistogram::bucketIndex(upperBound), index) << "Upper bound of bucket " << index;
+        ASSERT_EQ(LatencyHistogram::bucketIndex(upperBound + 1), index + 1) << "Value after bucket " << index;
+    }
+    // Relative error stays under 25%
+    for (uint64_t value = 8; value < 100000; value += 7) {
+        uint64_t upperBound = LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(value));
+        ASSERT_GE(upperBound, value);
+        ASSERT_LE(upperBound - value, value / 4);
+    }
+    // Huge values go in the last bucket
+    ASSERT_EQ(LatencyHistogram::bucketIndex(UINT64_MAX), LatencyHistogram::BucketCount - 1);
+}
+
+TEST(TestPerfMetrics, HistogramPercentiles)
+{
+    LatencyHistogram histogram;
+    HistogramSnapshot empty;
+    empty.merge(histogram);
+    ASSERT_EQ(empty.percentile(50), 0);
+    ASSERT_EQ(empty.mean(), 0);
+
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value);
+    }
+    HistogramSnapshot snapshot;
+    snapshot.merge(histogram);
+    ASSERT_EQ(snapshot.count, 1000);
+    ASSERT_EQ(snapshot.max, 1000);
+    ASSERT_EQ(snapshot.mean(), 500);
+    ASSERT_GE(snapshot.percentile(50), 500);
+    ASSERT_LE(snapshot.percentile(50), 625);
+    ASSERT_GE(snapshot.percentile(99), 990);
+    ASSERT_LE(snapshot.percentile(99), 1000);
+    ASSERT_EQ(snapshot.percentile(100), 1000);
+}
+
+TEST(TestPerfMetrics, CycleStatsDeviations)
+{
+    ASSERT_EQ(DeviationHistogram::bucketIndex(0), 0);
+    ASSERT_EQ(DeviationHistogram::bucketUpperBound(0), 0);
+    // Log-linear buckets in ms, contiguous up to the last one
+    for (int index = 0; index < DeviationHistogram::BucketCount - 1; index++) {
+        uint64_t upperBound = DeviationHistogram::bucketUpperBound(index);
+        ASSERT_EQ(DeviationHistogram::bucketIndex(upperBound), index) << "Upper bound of bucket " << index;
+        ASSERT_EQ(DeviationHistogram::bucketIndex(upperBound + 1), index + 1) << "Value after bucket " << index;
+    }
+    ASSERT_EQ(DeviationHistogram::bucketUpperBound(DeviationHistogram::BucketCount - 2), (1ULL << 17) - 1);
+    ASSERT_EQ(DeviationHistogram::bucketIndex(UINT64_MAX), DeviationHistogram::BucketCount - 1);
+    // Any deviation in the range of the histogram is known within 6.25%
+    for (uint64_t valueMs = 1; valueMs < (1ULL << 17); valueMs = valueMs * 9 / 8 + 1) {
+        uint64_t upperBound = DeviationHistogram::bucketUpperBound(DeviationHistogram::bucketIndex(valueMs));
+        ASSERT_GE(upperBound, valueMs);
+        ASSERT_LE(upperBound - valueMs, valueMs / 16) << "Deviation " << valueMs;
+    }
+    // About 1 KB per cyclic point, instead of the nanosecond range of the path latencies
+    ASSERT_LE(sizeof(CycleStats), 1024u);
+
+    CycleStats stats;
+    ASSERT_EQ(stats.getSnapshot().p50Ms, 0);
+    for (long deviation = 0; deviation < 100; deviation++) {
+        stats.record(deviation % 10, 5);
+    }
+    stats.record(-3, 5);
+    stats.record(1500, 5);
+    CycleStats::Snapshot snapshot = stats.getSnapshot();
+    ASSERT_EQ(snapshot.emissions, 102);
+    ASSERT_EQ(snapshot.lateEmissions, 41);
+    ASSERT_GE(snapshot.p50Ms, 4);
+    ASSERT_LE(snapshot.p50Ms, 7);
+    ASSERT_GE(snapshot.p99Ms, 9);
+    ASSERT_LE(snapshot.p99Ms, 15);
+    ASSERT_EQ(snapshot.maxMs, 1500);
+
+    // Percentiles of deviations spread over several powers of two stay within a few percent
+    CycleStats spread;
+    for (long deviation = 1; deviation <= 10000; deviation++) {
+        spread.record(deviation, 5000);
+    }
+    snapshot = spread.getSnapshot();
+    ASSERT_EQ(snapshot.lateEmissions, 5000);
+    ASSERT_GE(snapshot.p50Ms, 5000);
+    ASSERT_LE(snapshot.p50Ms, 5000 * 1.0625);
+    ASSERT_GE(snapshot.p99Ms, 9900);
+    ASSERT_LE(snapshot.p99Ms, 10000);
+    ASSERT_EQ(snapshot.maxMs, 10000);
+}
+
+TEST(TestPerfMetrics, AggregateThreads)
+{
+    PerfMetrics metrics;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 12; t++) {
+        threads.emplace_back([&metrics]() {
+            for (int i = 0; i < 1000; i++) {
+                metrics.increment(PerfMetrics::Counter::ReadingsAcces);
+                metrics.recordLatency(PerfMetrics::Latency::IngestCallback, 100);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    metrics.setCycleThreads(12);
+    metrics.setPoints(20);
+
+    PerfMetrics::Snapshot snapshot = metrics.getSnapshot();
+    ASSERT_EQ(snapshot.counter(PerfMetrics::Counter::ReadingsAcces), 12000);
+    ASSERT_EQ(snapshot.counter(PerfMetrics::Counter::ReadingsPrtInf), 0);
+    ASSERT_EQ(snapshot.latencyNs(PerfMetrics::Latency::IngestCallback).count, 12000);
+    ASSERT_EQ(snapshot.latencyNs(PerfMetrics::Latency::IngestCallback).max, 100);
+    ASSERT_EQ(snapshot.latencyNs(PerfMetrics::Latency::Reconfigure).count, 0);
+    ASSERT_EQ(snapshot.cycleThreads, 12);
+    ASSERT_EQ(snapshot.points, 20);
+}
+
+TEST(TestPerfMetrics, Names)
+{
+    ASSERT_STREQ(PerfMetrics::getCounterName(PerfMetrics::Counter::ReadingsAcces), "readings_acces");
+    ASSERT_STREQ(PerfMetrics::getCounterName(PerfMetrics::Counter::NotifyRejected), "notify_rejected");
+    ASSERT_STREQ(PerfMetrics::getLatencyName(PerfMetrics::Latency::IngestCallback), "ingest_callback");
+    ASSERT_STREQ(PerfMetrics::getLatencyName(PerfMetrics::Latency::Reconfigure), "reconfigure");
+    ASSERT_STREQ(PerfMetrics::getLatencyName(PerfMetrics::Latency::ConfigImport), "config_import");
+}
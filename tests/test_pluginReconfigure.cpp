@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <plugin_api.h>
 
+#include "asyncLogger.h"
 #include "notifySystemSp.h"
 
 using namespace systemspn;
@@ -53,4 +54,71 @@ TEST_F(TestPluginReconfigure, Reconfigure)
 {
 	plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), reconfigure);
     ASSERT_EQ(filter->isEnabled(), false);
-}
\ No newline at end of file
+}
+
+TEST_F(TestPluginReconfigure, ReconfigureLogRateLimit)
+{
+    ASSERT_EQ(filter->getLogRateLimit(), 100);
+    static std::string reconfigureRate = QUOTE({
+        "log_rate_limit": {
+            "value": "10"
+        }
+    });
+	plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), reconfigureRate);
+    ASSERT_EQ(filter->getLogRateLimit(), 10);
+
+    static std::string reconfigureInvalidRate = QUOTE({
+        "log_rate_limit": {
+            "value": "-1"
+        }
+    });
+	plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), reconfigureInvalidRate);
+    ASSERT_EQ(filter->getLogRateLimit(), 10);
+}
+
+TEST_F(TestPluginReconfigure, ReconfigureSharedAsyncLogging)
+{
+    AsyncLogger& asyncLogger = AsyncLogger::getInstance();
+    static std::string enableAsyncLogging = QUOTE({
+        "async_logging": {
+            "value": "true"
+        },
+        "async_logging_capacity": {
+            "value": "256"
+        }
+    });
+    static std::string disableAsyncLogging = QUOTE({
+        "async_logging": {
+            "value": "false"
+        }
+    });
+    PLUGIN_INFORMATION *info = plugin_info();
+    ConfigCategory *config = new ConfigCategory("systemsp", info->config);
+    config->setItemsValueFromDefault();
+    PLUGIN_HANDLE otherHandle = nullptr;
+    ASSERT_NO_THROW(otherHandle = plugin_init(config));
+    ASSERT_NE(otherHandle, nullptr);
+
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), enableAsyncLogging);
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(otherHandle), enableAsyncLogging);
+    ASSERT_TRUE(asyncLogger.isActive());
+    ASSERT_EQ(asyncLogger.getUsers(), 2);
+    ASSERT_EQ(asyncLogger.getCapacity(), 256);
+
+    // Same settings: the logger is not restarted
+    unsigned long flushedBefore = asyncLogger.getFlushedCount();
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), enableAsyncLogging);
+    ASSERT_EQ(asyncLogger.getUsers(), 2);
+    ASSERT_EQ(asyncLogger.getFlushedCount(), flushedBefore);
+
+    // Disabled by one instance, still used by the other one
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), disableAsyncLogging);
+    ASSERT_TRUE(asyncLogger.isActive());
+    ASSERT_EQ(asyncLogger.getUsers(), 1);
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), disableAsyncLogging);
+    ASSERT_EQ(asyncLogger.getUsers(), 1);
+
+    ASSERT_NO_THROW(plugin_shutdown(reinterpret_cast<PLUGIN_HANDLE*>(otherHandle)));
+    ASSERT_FALSE(asyncLogger.isActive());
+    ASSERT_EQ(asyncLogger.getUsers(), 0);
+}
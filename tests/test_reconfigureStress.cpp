@@ -0,0 +1,201 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <plugin_api.h>
+#include <dirent.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "notifySystemSp.h"
+#include "perfMetrics.h"
+
+using namespace systemspn;
+
+extern "C" {
+	PLUGIN_INFORMATION *plugin_info();
+	PLUGIN_HANDLE plugin_init(ConfigCategory *config);
+    void plugin_reconfigure(PLUGIN_HANDLE *handle, const std::string& newConfig);
+    bool plugin_deliver(PLUGIN_HANDLE handle,
+                    const std::string& deliveryName,
+                    const std::string& notificationName,
+                    const std::string& triggerReason,
+                    const std::string& message);
+    void plugin_registerIngest(PLUGIN_HANDLE *handle, void *func, void *data);
+    void plugin_shutdown(PLUGIN_HANDLE *handle);
+};
+
+class TestReconfigureStress : public testing::Test
+{
+protected:
+    static constexpr int CyclicPoints = 40;
+    static constexpr int PrtInfPoints = 10;
+    static constexpr int StressDurationMs = 3000;
+
+    struct IngestedReading {
+        uint64_t    sequence;
+        std::string assetName;
+    };
+
+    // Sequence numbers of the readings ingested around one reconfiguration
+    struct Reconfiguration {
+        uint64_t sequenceBefore;
+        uint64_t sequenceAfter;
+        char     configId;
+        bool     enabled;
+    };
+
+    static std::atomic<uint64_t>        readingSequence;
+    static std::mutex                   readingsMutex;
+    static std::vector<IngestedReading> readings;
+    std::string                         previousLevel;
+
+    void SetUp() override
+    {
+        previousLevel = Logger::getLogger()->getMinLevel();
+        Logger::getLogger()->setMinLevel("error");
+        readingSequence = 0;
+        readings.clear();
+    }
+
+    void TearDown() override
+    {
+        Logger::getLogger()->setMinLevel(previousLevel);
+    }
+
+    static void ingestCallback(void */*data*/, void *readingPtr) {
+        std::lock_guard<std::mutex> guard(readingsMutex);
+        readings.push_back({++readingSequence, static_cast<Reading*>(readingPtr)->getAssetName()});
+    }
+
+    static long countThreads() {
+        long threads = 0;
+        DIR *dir = opendir("/proc/self/task");
+        if (dir == nullptr) {
+            return -1;
+        }
+        while (struct dirent *entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                threads++;
+            }
+        }
+        closedir(dir);
+        return threads;
+    }
+
+    // Configuration whose status points assets are all prefixed with the configuration ID
+    static std::string buildConfig(char configId, bool enabled) {
+        std::string datapoints;
+        for (int i = 0; i < CyclicPoints + PrtInfPoints; i++) {
+            std::string index = std::to_string(i);
+            std::string label = std::string(1, configId) + "-" + index;
+            datapoints += std::string(i > 0 ? "," : "") + "{\"label\":\"" + label + "\",\"pivot_id\":\"" + label +
+                          "\",\"pivot_type\":\"SpsTyp\",\"protocols\":[]," +
+                          (i < CyclicPoints ? "\"pivot_subtypes\":[\"acces\"],\"ts_syst_cycle\":1}" :
+                                              "\"pivot_subtypes\":[\"prt.inf\",\"transient\"]}");
+        }
+        return std::string("{\"enable\":{\"value\":\"") + (enabled ? "true" : "false") +
+               "\"},\"exchanged_data\":{\"value\":{\"exchanged_data\":{\"datapoints\":[" + datapoints + "]}}}}";
+    }
+
+    // Latencies are kept in the test report (--gtest_output), the console output stays quiet
+    static void recordLatencies(const std::string& name, const LatencyHistogram& histogram) {
+        HistogramSnapshot snapshot;
+        snapshot.merge(histogram);
+        RecordProperty(name + "_calls", std::to_string(snapshot.count));
+        RecordProperty(name + "_p50_ns", std::to_string(snapshot.percentile(50)));
+        RecordProperty(name + "_p99_ns", std::to_string(snapshot.percentile(99)));
+        RecordProperty(name + "_max_ns", std::to_string(snapshot.max));
+    }
+};
+
+constexpr int TestReconfigureStress::CyclicPoints;
+constexpr int TestReconfigureStress::PrtInfPoints;
+constexpr int TestReconfigureStress::StressDurationMs;
+std::atomic<uint64_t> TestReconfigureStress::readingSequence{0};
+std::mutex TestReconfigureStress::readingsMutex;
+std::vector<TestReconfigureStress::IngestedReading> TestReconfigureStress::readings;
+
+TEST_F(TestReconfigureStress, ReconfigureUnderLoad)
+{
+    PLUGIN_INFORMATION *info = plugin_info();
+    ConfigCategory config("systemsp", info->config);
+    config.setItemsValueFromDefault();
+    PLUGIN_HANDLE handle = plugin_init(&config);
+    plugin_registerIngest(reinterpret_cast<PLUGIN_HANDLE*>(handle), (void*)ingestCallback, nullptr);
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(handle), buildConfig('A', true));
+    // Measured once the cycle scheduler thread was created, as sanitizers start their own background thread on first use
+    long threadsBefore = countThreads() - 1;
+
+    std::atomic<bool> running{true};
+    LatencyHistogram notifyLatencies;
+    LatencyHistogram reconfigureLatencies;
+    std::vector<Reconfiguration> reconfigurations;
+
+    std::vector<std::thread> notifyThreads;
+    for (int t = 0; t < 2; t++) {
+        notifyThreads.emplace_back([handle, &running, &notifyLatencies]() {
+            const std::string notifGiFinished = QUOTE({"asset": "gi_status", "reason": "finished"});
+            while (running) {
+                auto start = std::chrono::steady_clock::now();
+                plugin_deliver(handle, "delivery", "notification", notifGiFinished, "message");
+                notifyLatencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - start).count());
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+    }
+
+    // Alternates between 2 configurations with distinct status points, disabling the plugin from time to time
+    auto stressEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(StressDurationMs);
+    for (int i = 1; std::chrono::steady_clock::now() < stressEnd; i++) {
+        char configId = (i % 2) ? 'B' : 'A';
+        bool enabled = (i % 5) != 0;
+        std::string newConfig = buildConfig(configId, enabled);
+        Reconfiguration reconfiguration;
+        reconfiguration.configId = configId;
+        reconfiguration.enabled = enabled;
+        reconfiguration.sequenceBefore = readingSequence;
+        auto start = std::chrono::steady_clock::now();
+        plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(handle), newConfig);
+        reconfigureLatencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - start).count());
+        reconfiguration.sequenceAfter = readingSequence;
+        reconfigurations.push_back(reconfiguration);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    running = false;
+    for (auto& thread : notifyThreads) {
+        thread.join();
+    }
+    uint64_t sequenceEnd = readingSequence;
+    plugin_shutdown(reinterpret_cast<PLUGIN_HANDLE*>(handle));
+
+    recordLatencies("notify", notifyLatencies);
+    recordLatencies("reconfigure", reconfigureLatencies);
+    RecordProperty("reconfigurations", std::to_string(reconfigurations.size()));
+    RecordProperty("readings", std::to_string(sequenceEnd));
+    ASSERT_GT(reconfigurations.size(), 5);
+    ASSERT_GT(notifyLatencies.count.load(), 0);
+
+    // Between the end of a reconfiguration and the start of the next one, only the status points
+    // of the active configuration may emit, and nothing is emitted while the plugin is disabled
+    std::lock_guard<std::mutex> guard(readingsMutex);
+    for (std::size_t r = 0; r < reconfigurations.size(); r++) {
+        const Reconfiguration& reconfiguration = reconfigurations[r];
+        uint64_t windowEnd = (r + 1 < reconfigurations.size()) ? reconfigurations[r + 1].sequenceBefore : sequenceEnd;
+        for (const auto& reading : readings) {
+            if ((reading.sequence <= reconfiguration.sequenceAfter) || (reading.sequence > windowEnd)) {
+                continue;
+            }
+            ASSERT_TRUE(reconfiguration.enabled) << "Reading " << reading.assetName << " emitted while disabled";
+            ASSERT_EQ(reading.assetName[0], reconfiguration.configId) << "Reading emitted for removed point "
+                                                                      << reading.assetName;
+        }
+    }
+
+    // All cycle threads are joined once the plugin is shut down
+    ASSERT_EQ(countThreads(), threadsBefore);
+}
@@ -1,7 +1,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <plugin_api.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <queue>
+#include <sstream>
 
 #include "notifySystemSp.h"
 #include "constantsSystem.h"
@@ -157,6 +161,12 @@ protected:
         ingestCallbackCalled = 0;
     }
 
+    // Number of readings ingested, for tests where readings are also ingested by a plugin thread
+    static int getIngestCount() {
+        std::lock_guard<std::recursive_mutex> guard(storedReadingsMutex);
+        return ingestCallbackCalled;
+    }
+
     template<class... Args>
     static void debug_print(std::string format, Args&&... args) {
         printf(format.append("\n").c_str(), std::forward<Args>(args)...);
@@ -1076,7 +1086,7 @@ TEST_F(TestSystemSp, InvalidPivotType)
     // Manually add erroneous configuration for a TS with "acces" and "prt.inf" and an invalid pivot type
     // During a regular config import, this is prevented by ConfigPlugin::m_importDatapoint()
     // as messages with unexpected pivot type are ignored by it
-    filter->getConfigPlugin().addDataInfo("acces", std::make_shared<CyclicDataInfo>("invalid", "invalid", "invalid", 1));
+    filter->getConfigPlugin().addDataInfo("acces", std::make_shared<CyclicDataInfo>("invalid", "invalid", "invalid", 1000L));
     filter->getConfigPlugin().addDataInfo("prt.inf", std::make_shared<DataInfo>("invalid", "invalid", "invalid"));
 
     // Restart the cycles to take manual config into account
@@ -1097,4 +1107,1037 @@ TEST_F(TestSystemSp, InvalidPivotType)
     ASSERT_FALSE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
                 notifConnectionLost, "dummyMessage"));
     ASSERT_EQ(ingestCallbackCalled, 0);
-}
\ No newline at end of file
+}
+
+TEST_F(TestSystemSp, GiFinishedCoalescing)
+{
+	static std::string customConfig = QUOTE({
+        "enable" :{
+            "value": "true"
+        },
+        "gi_coalescing_window" :{
+            "value": "500"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {
+                            "label":"TS-3",
+                            "pivot_id":"M_2367_3_15_6",
+                            "pivot_type":"SpsTyp",
+                            "pivot_subtypes": [
+                                "prt.inf",
+                                "transient"
+                            ],
+                            "protocols":[
+                                {
+                                    "name":"IEC104",
+                                    "typeid":"M_ME_NC_3",
+                                    "address":"3271614"
+                                }
+                            ]
+                        }
+                    ]
+                }
+            }
+        }
+    });
+
+    debug_print("Reconfigure plugin");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), customConfig));
+    ASSERT_TRUE(filter->isEnabled());
+    ASSERT_EQ(filter->getGiCoalescingWindowMs(), 500);
+    unsigned long receivedBefore = filter->getGiTriggersReceived();
+    unsigned long mergedBefore = filter->getGiTriggersMerged();
+
+    std::string notifGiFinished = QUOTE({
+        "asset": "gi_status",
+        "reason": "finished"
+    });
+    debug_print("Sending burst of gi_status notifications");
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                    notifGiFinished, "dummyMessage"));
+    }
+    // Only one on/off pulse sent for the whole burst
+    ASSERT_EQ(getIngestCount(), 2);
+    ASSERT_EQ(filter->getGiTriggersReceived() - receivedBefore, 3);
+    ASSERT_EQ(filter->getGiTriggersMerged() - mergedBefore, 2);
+
+    debug_print("Trailing pulse sent at the end of the coalescing window");
+    waitUntil(ingestCallbackCalled, 4, 1000);
+    ASSERT_EQ(getIngestCount(), 4);
+
+    debug_print("Sending gi_status notification after the window of the trailing pulse");
+    std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_EQ(getIngestCount(), 6);
+    ASSERT_EQ(filter->getGiTriggersMerged() - mergedBefore, 2);
+
+    debug_print("Disable coalescing");
+    static std::string disableCoalescing = QUOTE({
+        "gi_coalescing_window" :{
+            "value": "0"
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), disableCoalescing));
+    ASSERT_EQ(filter->getGiCoalescingWindowMs(), 0);
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_EQ(getIngestCount(), 8);
+
+    // Invalid values are ignored
+    static std::string invalidCoalescing = QUOTE({
+        "gi_coalescing_window" :{
+            "value": "abc"
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), invalidCoalescing));
+    ASSERT_EQ(filter->getGiCoalescingWindowMs(), 0);
+}
+
+TEST_F(TestSystemSp, GiFinishedTrailingPulse)
+{
+    static std::string customConfig = QUOTE({
+        "gi_coalescing_window" :{
+            "value": "500"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {
+                            "label":"TS-3",
+                            "pivot_id":"M_2367_3_15_6",
+                            "pivot_type":"SpsTyp",
+                            "pivot_subtypes": ["prt.inf"],
+                            "protocols":[]
+                        }
+                    ]
+                }
+            }
+        }
+    });
+    ASSERT_NO_THROW(filter->stopCycles());
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    filter->setClock(clock);
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), customConfig));
+    ASSERT_EQ(clock->getParticipants(), 0);
+    resetCounters();
+    clearReadings();
+
+    std::string notifGiFinished = QUOTE({
+        "asset": "gi_status",
+        "reason": "finished"
+    });
+    debug_print("Single gi_status notification: no trailing pulse");
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_EQ(ingestCallbackCalled, 2);
+    ASSERT_EQ(clock->getParticipants(), 0);
+    ASSERT_TRUE(clock->advance(1000));
+    ASSERT_EQ(ingestCallbackCalled, 2);
+
+    debug_print("GI finished again inside the window of the first pulse");
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_TRUE(clock->advance(100));
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_TRUE(clock->advance(100));
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_EQ(ingestCallbackCalled, 4);
+    ASSERT_EQ(filter->getGiTriggersMerged(), 2);
+    // One trailing pulse for both merged notifications, sent at the end of the window
+    ASSERT_EQ(clock->getParticipants(), 1);
+    ASSERT_TRUE(clock->advance(299));
+    ASSERT_EQ(ingestCallbackCalled, 4);
+    ASSERT_TRUE(clock->advance(1));
+    ASSERT_EQ(ingestCallbackCalled, 6);
+    ASSERT_EQ(clock->getParticipants(), 0);
+
+    // The trailing pulse ends with the 'off' value
+    std::shared_ptr<Reading> lastReading;
+    {
+        std::lock_guard<std::recursive_mutex> guard(storedReadingsMutex);
+        while (!storedReadings.empty()) {
+            lastReading = storedReadings.front();
+            storedReadings.pop();
+        }
+    }
+    ASSERT_NE(lastReading.get(), nullptr);
+    validateReading(lastReading, "TS-3", "PIVOT", allPivotAttributeNames, {
+        {"GTIS.Identifier", {"string", "M_2367_3_15_6"}},
+        {"GTIS.Cause.stVal", {"int64_t", "3"}},
+        {"GTIS.TmOrg.stVal", {"string", "substituted"}},
+        {"GTIS.SpsTyp.stVal", {"int64_t", "0"}},
+        {"GTIS.SpsTyp.t.SecondSinceEpoch", {"int64_t", "1700000001"}},
+        {"GTIS.SpsTyp.t.FractionOfSecond", {"int64_t", "8388608"}},
+        {"GTIS.SpsTyp.q.Source", {"string", "substituted"}},
+    });
+
+    debug_print("GI finished after the window of the trailing pulse");
+    ASSERT_TRUE(clock->advance(600));
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_EQ(ingestCallbackCalled, 8);
+    ASSERT_EQ(clock->getParticipants(), 0);
+
+    debug_print("Pending trailing pulse cancelled by a change of clock");
+    ASSERT_TRUE(clock->advance(100));
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_EQ(clock->getParticipants(), 1);
+    filter->setClock(nullptr);
+    for (int i = 0; i < 100 && clock->getParticipants() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(clock->getParticipants(), 0);
+    ASSERT_EQ(ingestCallbackCalled, 8);
+}
+
+TEST_F(TestSystemSp, PerformanceMetrics)
+{
+    PerfMetrics::Snapshot before = filter->getMetrics();
+    // Configuration from SetUp contains 2 cyclic and 2 prt.inf status points
+    ASSERT_EQ(before.points, 4);
+    // Both cyclic points share the scheduler thread
+    ASSERT_EQ(before.cycleThreads, 1);
+    ASSERT_GE(before.latencyNs(PerfMetrics::Latency::Reconfigure).count, 1);
+
+    std::string notifGiFinished = QUOTE({
+        "asset": "gi_status",
+        "reason": "finished"
+    });
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    std::string notifInvalidJson = QUOTE({42});
+    ASSERT_FALSE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                 notifInvalidJson, "dummyMessage"));
+
+    PerfMetrics::Snapshot after = filter->getMetrics();
+    ASSERT_EQ(after.counter(PerfMetrics::Counter::NotifyReceived) - before.counter(PerfMetrics::Counter::NotifyReceived), 2);
+    ASSERT_EQ(after.counter(PerfMetrics::Counter::NotifyAccepted) - before.counter(PerfMetrics::Counter::NotifyAccepted), 1);
+    ASSERT_EQ(after.counter(PerfMetrics::Counter::NotifyRejected) - before.counter(PerfMetrics::Counter::NotifyRejected), 1);
+    ASSERT_EQ(after.counter(PerfMetrics::Counter::ReadingsPrtInf) - before.counter(PerfMetrics::Counter::ReadingsPrtInf), 4);
+    ASSERT_EQ(after.latencyNs(PerfMetrics::Latency::NotifyParse).count - before.latencyNs(PerfMetrics::Latency::NotifyParse).count, 2);
+    ASSERT_EQ(after.latencyNs(PerfMetrics::Latency::NotifyDispatch).count - before.latencyNs(PerfMetrics::Latency::NotifyDispatch).count, 1);
+    ASSERT_GE(after.latencyNs(PerfMetrics::Latency::IngestCallback).count - before.latencyNs(PerfMetrics::Latency::IngestCallback).count, 4);
+    ASSERT_GE(after.latencyNs(PerfMetrics::Latency::FillTemplate).count - before.latencyNs(PerfMetrics::Latency::FillTemplate).count, 4);
+    ASSERT_GE(after.latencyNs(PerfMetrics::Latency::BuildReading).count - before.latencyNs(PerfMetrics::Latency::BuildReading).count, 4);
+
+    ASSERT_NO_THROW(filter->stopCycles());
+    ASSERT_EQ(filter->getMetrics().cycleThreads, 0);
+}
+
+TEST_F(TestSystemSp, CycleDeadlineStats)
+{
+	static std::string customConfig = QUOTE({
+        "enable" :{
+            "value": "true"
+        },
+        "late_emission_threshold" :{
+            "value": "500"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {
+                            "label":"TS-1",
+                            "pivot_id":"M_2367_3_15_4",
+                            "pivot_type":"SpsTyp",
+                            "pivot_subtypes": [
+                                "acces"
+                            ],
+                            "ts_syst_cycle": 1,
+                            "protocols":[
+                                {
+                                    "name":"IEC104",
+                                    "typeid":"M_ME_NC_1",
+                                    "address":"3271612"
+                                }
+                            ]
+                        }
+                    ]
+                }
+            }
+        }
+    });
+
+    debug_print("Reconfigure plugin");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), customConfig));
+    ASSERT_EQ(filter->getLateThresholdMs(), 500);
+
+    CycleStats::Snapshot snapshot;
+    ASSERT_FALSE(filter->getCycleStats("M_2367_3_15_5", snapshot));
+    ASSERT_TRUE(filter->getCycleStats("M_2367_3_15_4", snapshot));
+    ASSERT_EQ(filter->getAllCycleStats().size(), 1);
+
+    // First emission is immediate and has no deadline, the next ones are checked against their deadline
+    debug_print("Waiting for cyclic emissions...");
+    waitUntil(ingestCallbackCalled, 4, 4000);
+    ASSERT_GE(ingestCallbackCalled, 4);
+    ASSERT_TRUE(filter->getCycleStats("M_2367_3_15_4", snapshot));
+    ASSERT_GE(snapshot.emissions, 3);
+    ASSERT_EQ(snapshot.lateEmissions, 0);
+    ASSERT_LE(snapshot.p50Ms, snapshot.p99Ms);
+    ASSERT_LE(snapshot.p99Ms, snapshot.maxMs);
+    ASSERT_LT(snapshot.maxMs, 500);
+}
+
+namespace {
+    // Simulated time only moved by the scheduler sleeps and by the ingest of readings
+    class IngestDelayClock : public Clock {
+    public:
+        static constexpr long IngestDelayMs = 5;
+
+        long nowMs() override { return m_nowMs; }
+        void sleepForMs(long durationMs, const std::atomic<bool>& running) override {
+            if (durationMs > 0) {
+                m_nowMs += durationMs;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        void ingest() {
+            m_nowMs += IngestDelayMs;
+            m_ingested++;
+        }
+        long getIngested() const { return m_ingested; }
+
+    private:
+        std::atomic<long> m_nowMs{0};
+        std::atomic<long> m_ingested{0};
+    };
+    constexpr long IngestDelayClock::IngestDelayMs;
+}
+
+TEST_F(TestSystemSp, LatenessIncludesBatchIngest)
+{
+    // More points due on the same tick than a shard batch, so that a batch is ingested within the tick
+    const int pointsCount = 300;
+    std::string datapoints;
+    for (int i = 0; i < pointsCount; i++) {
+        datapoints += std::string(i > 0 ? "," : "") + "{\"label\":\"TS-" + std::to_string(i) +
+                      "\",\"pivot_id\":\"M_" + std::to_string(i) +
+                      "\",\"pivot_type\":\"SpsTyp\",\"pivot_subtypes\":[\"acces\"],\"ts_syst_cycle\":10,\"protocols\":[]}";
+    }
+    std::string config = "{\"enable\":{\"value\":\"true\"},\"late_emission_threshold\":{\"value\":\"1000\"},"
+                         "\"exchanged_data\":{\"value\":{\"exchanged_data\":{\"datapoints\":[" + datapoints + "]}}}}";
+
+    ASSERT_NO_THROW(filter->stopCycles());
+    auto clock = std::make_shared<IngestDelayClock>();
+    filter->setClock(clock);
+    filter->registerIngest([](void *data, void *reading) {
+        static_cast<IngestDelayClock*>(data)->ingest();
+    }, clock.get());
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), config));
+    for (int i = 0; i < 500 && clock->getIngested() < 2 * pointsCount; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_NO_THROW(filter->stopCycles());
+    ASSERT_GE(clock->getIngested(), 2 * pointsCount);
+
+    // Emissions are recorded once their batch is ingested: the first batch (256 readings) when it is full,
+    // the other points at the end of the tick, after the ingest of both batches
+    const uint64_t firstBatchDelayMs = 256 * IngestDelayClock::IngestDelayMs;
+    const uint64_t lastBatchDelayMs = pointsCount * IngestDelayClock::IngestDelayMs;
+    int firstBatchPoints = 0;
+    int lastBatchPoints = 0;
+    for (const auto& stats : filter->getAllCycleStats()) {
+        ASSERT_GE(stats.second.emissions, 1);
+        ASSERT_EQ(stats.second.lateEmissions, stats.second.emissions);
+        if (stats.second.maxMs == firstBatchDelayMs) {
+            firstBatchPoints++;
+        }
+        else {
+            ASSERT_EQ(stats.second.maxMs, lastBatchDelayMs);
+            lastBatchPoints++;
+        }
+    }
+    ASSERT_EQ(firstBatchPoints, 256);
+    ASSERT_EQ(lastBatchPoints, pointsCount - 256);
+}
+
+TEST_F(TestSystemSp, TelemetryReadings)
+{
+	static std::string customConfig = QUOTE({
+        "enable" :{
+            "value": "true"
+        },
+        "stats_asset" :{
+            "value": "systemspn_stats"
+        },
+        "stats_period" :{
+            "value": "1"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : []
+                }
+            }
+        }
+    });
+
+    debug_print("Reconfigure plugin");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), customConfig));
+    ASSERT_TRUE(filter->isEnabled());
+    resetCounters();
+    clearReadings();
+
+    debug_print("Waiting for telemetry reading...");
+    waitUntil(ingestCallbackCalled, 1, 1500);
+    ASSERT_EQ(ingestCallbackCalled, 1);
+    std::shared_ptr<Reading> currentReading = popFrontReading();
+    ASSERT_NE(nullptr, currentReading.get());
+    ASSERT_EQ(currentReading->getAssetName(), "systemspn_stats");
+    for (const char *name : {"emissions", "drops", "log_queue_depth", "log_drops", "ingest_p99_us",
+                                    "notify_rate", "threads", "points"}) {
+        ASSERT_TRUE(hasObject(*currentReading, name)) << "Missing telemetry value: " << name;
+    }
+    ASSERT_EQ(getIntValue(*getObject(*currentReading, "points")), 0);
+    ASSERT_EQ(getIntValue(*getObject(*currentReading, "threads")), 1);
+
+    debug_print("Disable telemetry");
+    static std::string disableStats = QUOTE({
+        "stats_asset" :{
+            "value": ""
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), disableStats));
+    resetCounters();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    ASSERT_EQ(ingestCallbackCalled, 0);
+}
+
+TEST_F(TestSystemSp, SpanTracing)
+{
+	static std::string enableTracing = QUOTE({
+        "trace_enable" :{
+            "value": "true"
+        },
+        "trace_capacity" :{
+            "value": "1024"
+        },
+        "trace_file" :{
+            "value": "test_systemSP_trace.json"
+        }
+    });
+
+    debug_print("Enable tracing");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), enableTracing));
+    ASSERT_TRUE(TraceRecorder::getInstance().isEnabled());
+    std::string notifGiFinished = QUOTE({
+        "asset": "gi_status",
+        "reason": "finished"
+    });
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                notifGiFinished, "dummyMessage"));
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), enableTracing));
+
+    debug_print("Dump trace");
+    ASSERT_TRUE(filter->dumpTrace());
+    std::ifstream file("test_systemSP_trace.json");
+    std::stringstream content;
+    content << file.rdbuf();
+    for (const char *name : {"notifyParse", "notifyDispatch", "fillTemplate", "sendReading", "ingest", "reconfigure"}) {
+        ASSERT_NE(content.str().find(std::string("\"name\":\"") + name + "\""), std::string::npos)
+            << "Missing span: " << name;
+    }
+
+    debug_print("Disable tracing");
+    static std::string disableTracing = QUOTE({
+        "trace_enable" :{
+            "value": "false"
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), disableTracing));
+    ASSERT_FALSE(TraceRecorder::getInstance().isEnabled());
+    std::remove("test_systemSP_trace.json");
+}
+
+TEST_F(TestSystemSp, VirtualTimeCadence)
+{
+    static std::string customConfig = QUOTE({
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {
+                            "label":"TS-1",
+                            "pivot_id":"M_2367_3_15_4",
+                            "pivot_type":"SpsTyp",
+                            "pivot_subtypes": ["acces"],
+                            "ts_syst_cycle": 1,
+                            "protocols":[]
+                        },
+                        {
+                            "label":"TS-2",
+                            "pivot_id":"M_2367_3_15_5",
+                            "pivot_type":"DpsTyp",
+                            "pivot_subtypes": ["acces"],
+                            "ts_syst_cycle": 7,
+                            "protocols":[]
+                        },
+                        {
+                            "label":"TS-3",
+                            "pivot_id":"M_2367_3_15_6",
+                            "pivot_type":"SpsTyp",
+                            "pivot_subtypes": ["prt.inf"],
+                            "protocols":[]
+                        }
+                    ]
+                }
+            }
+        },
+        "gi_coalescing_window": {
+            "value": "10000"
+        }
+    });
+    // Cycles of the configuration from SetUp are stopped, so that they are not restarted on the virtual clock
+    ASSERT_NO_THROW(filter->stopCycles());
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    filter->setClock(clock);
+    ASSERT_EQ(filter->getClock(), clock);
+    ASSERT_EQ(clock->getParticipants(), 0);
+
+    // Readings are only counted, storing 4000 of them is not needed
+    static std::map<std::string, int> readingsPerAsset;
+    readingsPerAsset.clear();
+    filter->registerIngest([](void*, void *readingPtr) {
+        readingsPerAsset[static_cast<Reading*>(readingPtr)->getAssetName()]++;
+    }, nullptr);
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), customConfig));
+    // All cyclic points are emitted by a single scheduler thread
+    ASSERT_EQ(clock->getParticipants(), 1);
+    ASSERT_TRUE(clock->waitForSleepers());
+    // First emission of each cyclic point happens at startup
+    ASSERT_EQ(readingsPerAsset["TS-1"], 1);
+    ASSERT_EQ(readingsPerAsset["TS-2"], 1);
+
+    debug_print("Simulate one hour of emissions");
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(clock->advance(3600 * 1000));
+    debug_print("One hour simulated in %ld ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count());
+    ASSERT_EQ(clock->nowMs(), 1700000000000 + 3600 * 1000);
+    ASSERT_EQ(readingsPerAsset["TS-1"], 3601);
+    ASSERT_EQ(readingsPerAsset["TS-2"], 3600 / 7 + 1);
+
+    // Virtual deadlines are met exactly
+    CycleStats::Snapshot stats;
+    ASSERT_TRUE(filter->getCycleStats("M_2367_3_15_4", stats));
+    ASSERT_EQ(stats.emissions, 3600);
+    ASSERT_EQ(stats.lateEmissions, 0);
+    ASSERT_EQ(stats.maxMs, 0);
+
+    debug_print("gi_status coalescing uses the same clock");
+    std::string notifGiFinished = QUOTE({
+        "asset": "gi_status",
+        "reason": "finished"
+    });
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(filter), "dummyDeliveryName", "dummyNotificationName",
+                    notifGiFinished, "dummyMessage"));
+        ASSERT_TRUE(clock->advance(4000));
+    }
+    ASSERT_EQ(filter->getGiTriggersReceived(), 3);
+    ASSERT_EQ(filter->getGiTriggersMerged(), 2);
+    // Leading pulse and trailing pulse at the end of the window
+    ASSERT_EQ(readingsPerAsset["TS-3"], 4);
+
+    ASSERT_NO_THROW(filter->stopCycles());
+    ASSERT_EQ(clock->getParticipants(), 0);
+}
+
+TEST_F(TestSystemSp, BackgroundInitialization)
+{
+    // Configuration large enough for the import to still be running when plugin_init returns
+    const size_t prtInfPoints = 2000;
+    std::string datapoints;
+    for (size_t i = 0; i < prtInfPoints; i++) {
+        std::string index = std::to_string(i);
+        datapoints += std::string(i > 0 ? "," : "") + "{\"label\":\"TS-" + index + "\",\"pivot_id\":\"M_" + index +
+                      "\",\"pivot_type\":\"SpsTyp\",\"pivot_subtypes\":[\"prt.inf\",\"transient\"],\"protocols\":[]}";
+    }
+    PLUGIN_INFORMATION *info = plugin_info();
+    ConfigCategory *config = new ConfigCategory("systemsp", info->config);
+    config->setItemsValueFromDefault();
+    config->setValue("enable", "true");
+    config->setValue("background_init", "true");
+    config->setValue("exchanged_data", "{\"exchanged_data\":{\"datapoints\":[" + datapoints + "]}}");
+
+    debug_print("Initialize in background");
+    PLUGIN_HANDLE handle = nullptr;
+    ASSERT_NO_THROW(handle = plugin_init(config));
+    auto backgroundFilter = static_cast<NotifySystemSp *>(handle);
+    ASSERT_TRUE(backgroundFilter->isEnabled());
+    std::atomic<size_t> ingested{0};
+    auto countingIngest = [](void *data, void */*readingPtr*/) { (*static_cast<std::atomic<size_t>*>(data))++; };
+    FuncPtr ingestPtr = countingIngest;
+    ASSERT_NO_THROW(plugin_registerIngest(reinterpret_cast<PLUGIN_HANDLE*>(backgroundFilter), (void*)ingestPtr, &ingested));
+
+    debug_print("Early notification is handled with the complete configuration");
+    std::string notifGiFinished = QUOTE({
+        "asset": "gi_status",
+        "reason": "finished"
+    });
+    ASSERT_TRUE(plugin_deliver(reinterpret_cast<PLUGIN_HANDLE*>(backgroundFilter), "dummyDeliveryName",
+                "dummyNotificationName", notifGiFinished, "dummyMessage"));
+    ASSERT_FALSE(backgroundFilter->isInitializing());
+    ASSERT_EQ(backgroundFilter->getConfigPlugin().getDataSystem().at("prt.inf").size(), prtInfPoints);
+    ASSERT_EQ(backgroundFilter->getMetrics().counter(PerfMetrics::Counter::ReadingsPrtInf), 2 * prtInfPoints);
+    ASSERT_EQ(ingested, 2 * prtInfPoints);
+
+    debug_print("A reconfigure is applied after the background import");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(backgroundFilter), configure));
+    ASSERT_EQ(backgroundFilter->getConfigPlugin().getDataSystem().at("prt.inf").size(), 2u);
+    ASSERT_NO_THROW(plugin_shutdown(reinterpret_cast<PLUGIN_HANDLE*>(backgroundFilter)));
+    delete config;
+}
+
+TEST_F(TestSystemSp, EmissionStateResumesCadence)
+{
+    static std::string persistedConfig = QUOTE({
+        "enable" :{
+            "value": "true"
+        },
+        "emission_state": {
+            "value": "true"
+        },
+        "emission_state_file": {
+            "value": "test_systemSP_emission.state"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {
+                            "label":"TS-1",
+                            "pivot_id":"M_2367_3_15_4",
+                            "pivot_type":"SpsTyp",
+                            "pivot_subtypes": ["acces"],
+                            "ts_syst_cycle": 30,
+                            "protocols":[]
+                        },
+                        {
+                            "label":"TS-2",
+                            "pivot_id":"M_2367_3_15_5",
+                            "pivot_type":"DpsTyp",
+                            "pivot_subtypes": ["acces"],
+                            "ts_syst_cycle": 30,
+                            "protocols":[]
+                        }
+                    ]
+                }
+            }
+        }
+    });
+    std::remove("test_systemSP_emission.state");
+    ASSERT_NO_THROW(filter->stopCycles());
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    filter->setClock(clock);
+    static std::map<std::string, int> readingsPerAsset;
+    readingsPerAsset.clear();
+    FuncPtr countReadings = [](void*, void *readingPtr) {
+        readingsPerAsset[static_cast<Reading*>(readingPtr)->getAssetName()]++;
+    };
+    filter->registerIngest(countReadings, nullptr);
+
+    debug_print("First start emits all points");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), persistedConfig));
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_EQ(readingsPerAsset["TS-1"], 1);
+    ASSERT_EQ(readingsPerAsset["TS-2"], 1);
+    ASSERT_TRUE(clock->advance(10000));
+
+    debug_print("Restart resumes the cadence without burst nor gap");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), persistedConfig));
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_EQ(readingsPerAsset["TS-1"], 1);
+    ASSERT_EQ(readingsPerAsset["TS-2"], 1);
+    ASSERT_TRUE(clock->advance(19999));
+    ASSERT_EQ(readingsPerAsset["TS-1"], 1);
+    ASSERT_TRUE(clock->advance(1));
+    ASSERT_EQ(readingsPerAsset["TS-1"], 2);
+    ASSERT_EQ(readingsPerAsset["TS-2"], 2);
+
+    debug_print("A new instance resumes from the file");
+    ASSERT_NO_THROW(filter->stopCycles());
+    {
+        NotifySystemSp restarted;
+        restarted.setClock(clock);
+        restarted.registerIngest(countReadings, nullptr);
+        ASSERT_TRUE(clock->advance(5000));
+        ConfigCategory config("restarted", persistedConfig);
+        restarted.reconfigure(config);
+        ASSERT_TRUE(clock->waitForSleepers());
+        ASSERT_EQ(readingsPerAsset["TS-1"], 2);
+        ASSERT_TRUE(clock->advance(25000));
+        ASSERT_EQ(readingsPerAsset["TS-1"], 3);
+        restarted.stopCycles();
+    }
+
+    debug_print("Without persistence, a restart emits all points");
+    static std::string notPersisted = QUOTE({
+        "emission_state": {
+            "value": "false"
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), notPersisted));
+    ASSERT_NO_THROW(filter->startCycles());
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_EQ(readingsPerAsset["TS-1"], 4);
+    ASSERT_EQ(readingsPerAsset["TS-2"], 4);
+    ASSERT_NO_THROW(filter->stopCycles());
+    std::remove("test_systemSP_emission.state");
+}
+
+TEST_F(TestSystemSp, EmissionStatePerInstance)
+{
+    static std::string persistedConfig = QUOTE({
+        "enable" :{
+            "value": "true"
+        },
+        "emission_state": {
+            "value": "true"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {"label":"TS-1", "pivot_id":"M_1", "pivot_type":"SpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle": 30, "protocols":[]}
+                    ]
+                }
+            }
+        }
+    });
+    const char *fledgeData = getenv("FLEDGE_DATA");
+    const std::string savedData = fledgeData ? fledgeData : "";
+    setenv("FLEDGE_DATA", ".", 1);
+    const std::string firstFile = "./" FILTER_NAME "_deliveryA_emission.state";
+    const std::string secondFile = "./" FILTER_NAME "_deliveryB_emission.state";
+    std::remove(firstFile.c_str());
+    std::remove(secondFile.c_str());
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    static int readings = 0;
+    readings = 0;
+    FuncPtr countReadings = [](void*, void*) { readings++; };
+
+    debug_print("Instances using the default file do not share it");
+    NotifySystemSp first;
+    first.setClock(clock);
+    first.registerIngest(countReadings, nullptr);
+    first.initialize(ConfigCategory("deliveryA", persistedConfig));
+    NotifySystemSp second;
+    second.setClock(clock);
+    second.registerIngest(countReadings, nullptr);
+    second.initialize(ConfigCategory("deliveryB", persistedConfig));
+    ASSERT_EQ(first.getEmissionStateFile(), firstFile);
+    ASSERT_EQ(second.getEmissionStateFile(), secondFile);
+    ASSERT_TRUE(first.isEmissionStateOpen());
+    ASSERT_TRUE(second.isEmissionStateOpen());
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_TRUE(clock->advance(30000));
+    ASSERT_EQ(readings, 4);
+
+    debug_print("A file in use is not opened by another instance");
+    {
+        NotifySystemSp sameName;
+        sameName.setClock(clock);
+        sameName.registerIngest(countReadings, nullptr);
+        sameName.initialize(ConfigCategory("deliveryA", persistedConfig));
+        ASSERT_FALSE(sameName.isEmissionStateOpen());
+        ASSERT_TRUE(clock->waitForSleepers());
+        ASSERT_EQ(readings, 5);
+        sameName.stopCycles();
+    }
+    // The first instance still updates its file
+    ASSERT_TRUE(clock->advance(30000));
+    ASSERT_EQ(readings, 7);
+    first.stopCycles();
+    second.stopCycles();
+    std::remove(firstFile.c_str());
+    std::remove(secondFile.c_str());
+
+    debug_print("Without a data directory, the emission state is not persisted");
+    const char *fledgeRoot = getenv("FLEDGE_ROOT");
+    const std::string savedRoot = fledgeRoot ? fledgeRoot : "";
+    unsetenv("FLEDGE_DATA");
+    unsetenv("FLEDGE_ROOT");
+    {
+        NotifySystemSp noDirectory;
+        noDirectory.setClock(clock);
+        noDirectory.registerIngest(countReadings, nullptr);
+        noDirectory.initialize(ConfigCategory("deliveryC", persistedConfig));
+        ASSERT_EQ(noDirectory.getEmissionStateFile(), "");
+        ASSERT_FALSE(noDirectory.isEmissionStateOpen());
+        noDirectory.stopCycles();
+    }
+    if (fledgeRoot) {
+        setenv("FLEDGE_ROOT", savedRoot.c_str(), 1);
+    }
+    if (fledgeData) {
+        setenv("FLEDGE_DATA", savedData.c_str(), 1);
+    }
+}
+
+TEST_F(TestSystemSp, DroppedReadingsNotCounted)
+{
+    static std::string droppedConfig = QUOTE({
+        "enable" :{
+            "value": "true"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {"label":"TS-1", "pivot_id":"M_1", "pivot_type":"SpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle": 1, "protocols":[]},
+                        {"label":"TS-2", "pivot_id":"M_2", "pivot_type":"SpsTyp", "pivot_subtypes": ["prt.inf", "transient"], "protocols":[]}
+                    ]
+                }
+            }
+        }
+    });
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    NotifySystemSp noCallback;
+    noCallback.setClock(clock);
+    noCallback.initialize(ConfigCategory("deliveryDropped", droppedConfig));
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_TRUE(clock->advance(1000));
+
+    debug_print("Readings without ingest callback are only counted as dropped");
+    ASSERT_FALSE(noCallback.sendPrtInfSP(true));
+    PerfMetrics::Snapshot metrics = noCallback.getMetrics();
+    ASSERT_EQ(metrics.counter(PerfMetrics::Counter::ReadingsAcces), 0u);
+    ASSERT_EQ(metrics.counter(PerfMetrics::Counter::ReadingsPrtInf), 0u);
+    ASSERT_EQ(metrics.counter(PerfMetrics::Counter::ReadingsDropped), 3u);
+
+    debug_print("Readings are counted once the callback is registered");
+    static int readings = 0;
+    readings = 0;
+    noCallback.registerIngest([](void*, void*) { readings++; }, nullptr);
+    ASSERT_TRUE(clock->advance(1000));
+    ASSERT_TRUE(noCallback.sendPrtInfSP(true));
+    metrics = noCallback.getMetrics();
+    ASSERT_EQ(readings, 2);
+    ASSERT_EQ(metrics.counter(PerfMetrics::Counter::ReadingsAcces), 1u);
+    ASSERT_EQ(metrics.counter(PerfMetrics::Counter::ReadingsPrtInf), 1u);
+    ASSERT_EQ(metrics.counter(PerfMetrics::Counter::ReadingsDropped), 3u);
+    noCallback.stopCycles();
+}
+
+TEST_F(TestSystemSp, StartupRamp)
+{
+    static std::string rampConfig = QUOTE({
+        "startup_ramp": {
+            "value": "2000"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {"label":"TS-d", "pivot_id":"M_d", "pivot_type":"SpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle": 10, "protocols":[]},
+                        {"label":"TS-a", "pivot_id":"M_a", "pivot_type":"SpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle": 10, "protocols":[]},
+                        {"label":"TS-c", "pivot_id":"M_c", "pivot_type":"DpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle": 10, "protocols":[]},
+                        {"label":"TS-b", "pivot_id":"M_b", "pivot_type":"DpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle": 1, "protocols":[]}
+                    ]
+                }
+            }
+        }
+    });
+    ASSERT_NO_THROW(filter->stopCycles());
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    filter->setClock(clock);
+    static std::vector<std::pair<std::string, long>> emissions;
+    emissions.clear();
+    static std::shared_ptr<VirtualClock> emissionClock;
+    emissionClock = clock;
+    filter->registerIngest([](void*, void *readingPtr) {
+        emissions.emplace_back(static_cast<Reading*>(readingPtr)->getAssetName(), emissionClock->nowMs() - 1700000000000);
+    }, nullptr);
+
+    debug_print("First emissions are spread over the ramp in pivot ID order");
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), rampConfig));
+    ASSERT_EQ(filter->getStartupRampMs(), 2000);
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_TRUE(clock->advance(1999));
+    std::vector<std::pair<std::string, long>> expected = {
+        // The ramp of TS-b is limited to its 1 s cycle
+        {"TS-a", 0}, {"TS-b", 250}, {"TS-c", 1000}, {"TS-b", 1250}, {"TS-d", 1500}
+    };
+    ASSERT_EQ(emissions, expected);
+
+    debug_print("Without ramp, all points are sent at start");
+    static std::string noRamp = QUOTE({
+        "startup_ramp": {
+            "value": "0"
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), noRamp));
+    emissions.clear();
+    ASSERT_NO_THROW(filter->startCycles());
+    ASSERT_TRUE(clock->waitForSleepers());
+    ASSERT_EQ(emissions.size(), 4u);
+    ASSERT_NO_THROW(filter->stopCycles());
+    emissionClock.reset();
+}
+
+TEST_F(TestSystemSp, MillisecondCycles)
+{
+    static std::string msConfig = QUOTE({
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {"label":"TS-100", "pivot_id":"M_100", "pivot_type":"SpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle_ms": 100, "protocols":[]},
+                        {"label":"TS-250", "pivot_id":"M_250", "pivot_type":"SpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle_ms": 250, "protocols":[]},
+                        {"label":"TS-500", "pivot_id":"M_500", "pivot_type":"DpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle_ms": 500, "ts_syst_cycle": 30, "protocols":[]},
+                        {"label":"TS-1s", "pivot_id":"M_1s", "pivot_type":"DpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle": 1, "protocols":[]}
+                    ]
+                }
+            }
+        }
+    });
+    ASSERT_NO_THROW(filter->stopCycles());
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    filter->setClock(clock);
+    static std::map<std::string, int> readingsPerAsset;
+    readingsPerAsset.clear();
+    filter->registerIngest([](void*, void *readingPtr) {
+        readingsPerAsset[static_cast<Reading*>(readingPtr)->getAssetName()]++;
+    }, nullptr);
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), msConfig));
+    ASSERT_EQ(clock->getParticipants(), 1);
+    ASSERT_TRUE(clock->waitForSleepers());
+
+    debug_print("Simulate 10 s of sub-second emissions");
+    ASSERT_TRUE(clock->advance(10000));
+    ASSERT_EQ(readingsPerAsset["TS-100"], 101);
+    ASSERT_EQ(readingsPerAsset["TS-250"], 41);
+    // ts_syst_cycle_ms takes precedence over ts_syst_cycle
+    ASSERT_EQ(readingsPerAsset["TS-500"], 21);
+    ASSERT_EQ(readingsPerAsset["TS-1s"], 11);
+
+    // Deadlines are previous deadline plus cycle, the cadence does not drift
+    CycleStats::Snapshot stats;
+    ASSERT_TRUE(filter->getCycleStats("M_100", stats));
+    ASSERT_EQ(stats.emissions, 100);
+    ASSERT_EQ(stats.lateEmissions, 0);
+    ASSERT_EQ(stats.maxMs, 0);
+    ASSERT_NO_THROW(filter->stopCycles());
+}
+
+TEST_F(TestSystemSp, SchedulerShards)
+{
+    const int cyclicPoints = 32;
+    std::string datapoints;
+    for (int i = 0; i < cyclicPoints; i++) {
+        std::string index = std::to_string(i);
+        datapoints += std::string(i > 0 ? "," : "") + "{\"label\":\"TS-" + index + "\",\"pivot_id\":\"M_" + index +
+                      "\",\"pivot_type\":\"SpsTyp\",\"pivot_subtypes\":[\"acces\"],\"ts_syst_cycle_ms\":500,\"protocols\":[]}";
+    }
+    std::string shardsConfig = "{\"scheduler_shards\":{\"value\":\"4\"},\"scheduler_cpu_affinity\":{\"value\":\"true\"},"
+                               "\"exchanged_data\":{\"value\":{\"exchanged_data\":{\"datapoints\":[" + datapoints + "]}}}}";
+    ASSERT_NO_THROW(filter->stopCycles());
+    auto clock = std::make_shared<VirtualClock>(1700000000000);
+    filter->setClock(clock);
+    uint64_t readingsBefore = filter->getMetrics().counter(PerfMetrics::Counter::ReadingsAcces);
+    static std::map<std::string, int> readingsPerAsset;
+    readingsPerAsset.clear();
+    filter->registerIngest([](void*, void *readingPtr) {
+        readingsPerAsset[static_cast<Reading*>(readingPtr)->getAssetName()]++;
+    }, nullptr);
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), shardsConfig));
+    ASSERT_EQ(filter->getSchedulerShards(), 4u);
+    // One thread per shard owning at least one point
+    long cycleThreads = filter->getMetrics().cycleThreads;
+    ASSERT_GT(cycleThreads, 1);
+    ASSERT_LE(cycleThreads, 4);
+    ASSERT_EQ(clock->getParticipants(), cycleThreads);
+    ASSERT_TRUE(clock->waitForSleepers());
+
+    debug_print("Every point is emitted once per cycle whatever its shard");
+    ASSERT_TRUE(clock->advance(5000));
+    ASSERT_EQ(readingsPerAsset.size(), static_cast<size_t>(cyclicPoints));
+    for (const auto& readings : readingsPerAsset) {
+        ASSERT_EQ(readings.second, 11) << "Unexpected emissions for " << readings.first;
+    }
+    ASSERT_EQ(filter->getMetrics().counter(PerfMetrics::Counter::ReadingsAcces) - readingsBefore, 11u * cyclicPoints);
+
+    debug_print("Invalid shard counts are ignored");
+    static std::string invalidShards = QUOTE({
+        "scheduler_shards": {
+            "value": "0"
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), invalidShards));
+    ASSERT_EQ(filter->getSchedulerShards(), 4u);
+    static std::string tooManyShards = QUOTE({
+        "scheduler_shards": {
+            "value": "65"
+        }
+    });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), tooManyShards));
+    ASSERT_EQ(filter->getSchedulerShards(), 4u);
+    ASSERT_NO_THROW(filter->stopCycles());
+    ASSERT_EQ(clock->getParticipants(), 0);
+}
+
+TEST_F(TestSystemSp, SchedulerEventLoop)
+{
+    static std::string fastCycleConfig = QUOTE({
+        "enable": {
+            "value": "true"
+        },
+        "exchanged_data": {
+            "value" : {
+                "exchanged_data": {
+                    "datapoints" : [
+                        {"label":"TS-1", "pivot_id":"M_1", "pivot_type":"SpsTyp", "pivot_subtypes": ["acces"], "ts_syst_cycle_ms": 200, "protocols":[]}
+                    ]
+                }
+            }
+        }
+    });
+    static std::atomic<int> readings{0};
+    readings = 0;
+    filter->registerIngest([](void*, void*) { readings++; }, nullptr);
+    auto waitForReadings = [](int count, long timeoutMs) {
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (readings < count && std::chrono::steady_clock::now() < end) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return readings >= count;
+    };
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), fastCycleConfig));
+    ASSERT_TRUE(filter->isUsingSchedulerEventLoop());
+    ASSERT_TRUE(waitForReadings(3, 2000));
+
+    debug_print("No emission while disabled, the scheduler waits without deadline");
+    static std::string disable = QUOTE({ "enable": { "value": "false" } });
+    static std::string enable = QUOTE({ "enable": { "value": "true" } });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), disable));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int disabledReadings = readings;
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    ASSERT_EQ(readings, disabledReadings);
+
+    debug_print("Enabling wakes the scheduler up, the overdue point is sent at once");
+    auto enableTime = std::chrono::steady_clock::now();
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), enable));
+    ASSERT_TRUE(waitForReadings(disabledReadings + 1, 1000));
+    ASSERT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - enableTime).count(), 500);
+
+    debug_print("Sleeping scheduler when the event loop is disabled");
+    static std::string noEventLoop = QUOTE({ "scheduler_event_loop": { "value": "false" } });
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), noEventLoop));
+    ASSERT_NO_THROW(plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(filter), fastCycleConfig));
+    ASSERT_FALSE(filter->isUsingSchedulerEventLoop());
+    int sleepingReadings = readings;
+    ASSERT_TRUE(waitForReadings(sleepingReadings + 2, 2000));
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <random>
+
+#include "timingWheel.h"
+
+using namespace systemspn;
+
+namespace {
+    std::vector<std::size_t> advanceIds(TimingWheel& wheel, long nowMs) {
+        std::vector<TimingWheel::Expired> expired;
+        wheel.advance(nowMs, expired);
+        std::vector<std::size_t> ids;
+        for (const auto& entry : expired) {
+            ids.push_back(entry.id);
+        }
+        return ids;
+    }
+}
+
+TEST(TestTimingWheel, ExpireInDeadlineOrder)
+{
+    TimingWheel wheel;
+    wheel.reset(1000);
+    ASSERT_EQ(wheel.getNextDeadlineMs(), LONG_MAX);
+    wheel.schedule(0, 1100);
+    wheel.schedule(1, 1005);
+    wheel.schedule(2, 1100);
+    // Already passed deadline expires on the next advance
+    wheel.schedule(3, 900);
+    ASSERT_EQ(wheel.size(), 4u);
+    ASSERT_EQ(wheel.getNextDeadlineMs(), 1000);
+
+    std::vector<TimingWheel::Expired> expired;
+    wheel.advance(1000, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    ASSERT_EQ(expired[0].id, 3u);
+    ASSERT_EQ(expired[0].deadlineMs, 900);
+    ASSERT_FALSE(wheel.isScheduled(3));
+    ASSERT_EQ(wheel.getNextDeadlineMs(), 1005);
+
+    ASSERT_EQ(advanceIds(wheel, 1099), std::vector<std::size_t>({1}));
+    // Same slot: scheduling order
+    ASSERT_EQ(advanceIds(wheel, 1100), std::vector<std::size_t>({0, 2}));
+    ASSERT_EQ(wheel.size(), 0u);
+    ASSERT_EQ(wheel.getCurrentMs(), 1101);
+}
+
+TEST(TestTimingWheel, CascadeFromUpperLevels)
+{
+    TimingWheel wheel;
+    wheel.reset(0);
+    // One deadline in each level, up to the 18 h slots of the last level
+    const std::vector<long> deadlines = {200, 10000, 600000, 3600000, 86400000, 30L * 86400000};
+    for (std::size_t i = 0; i < deadlines.size(); i++) {
+        wheel.schedule(i, deadlines[i]);
+    }
+    long nowMs = 0;
+    for (std::size_t i = 0; i < deadlines.size(); i++) {
+        // The next deadline is a lower bound, advancing to it cascades the entries down to their slot
+        while (wheel.getNextDeadlineMs() < deadlines[i]) {
+            long nextMs = wheel.getNextDeadlineMs();
+            ASSERT_GT(nextMs, nowMs);
+            nowMs = nextMs;
+            ASSERT_TRUE(advanceIds(wheel, nowMs).empty()) << "Early expiry at " << nowMs;
+        }
+        ASSERT_EQ(wheel.getNextDeadlineMs(), deadlines[i]);
+        ASSERT_TRUE(advanceIds(wheel, deadlines[i] - 1).empty());
+        ASSERT_EQ(advanceIds(wheel, deadlines[i]), std::vector<std::size_t>({i}));
+        nowMs = deadlines[i];
+    }
+    ASSERT_EQ(wheel.size(), 0u);
+}
+
+TEST(TestTimingWheel, RescheduleAndCancel)
+{
+    TimingWheel wheel;
+    wheel.reset(0);
+    wheel.schedule(0, 50000);
+    wheel.schedule(1, 50000);
+    wheel.schedule(2, 20);
+    // Moved from an upper level to the first one and back
+    wheel.schedule(0, 10);
+    wheel.schedule(2, 3600000);
+    wheel.cancel(1);
+    wheel.cancel(1);
+    wheel.cancel(42);
+    ASSERT_FALSE(wheel.isScheduled(1));
+    ASSERT_EQ(wheel.size(), 2u);
+    ASSERT_EQ(advanceIds(wheel, 100000), std::vector<std::size_t>({0}));
+    ASSERT_EQ(advanceIds(wheel, 3600000), std::vector<std::size_t>({2}));
+}
+
+TEST(TestTimingWheel, MatchesOrderedReference)
+{
+    // Cyclic entries with second to hour scale cycles, advanced by random steps
+    std::mt19937 random(42);
+    std::uniform_int_distribution<long> cycleDistribution(1, 3600);
+    std::uniform_int_distribution<long> stepDistribution(1, 5000);
+    const std::size_t entries = 2000;
+    const long startMs = 1700000000123;
+    TimingWheel wheel;
+    wheel.reset(startMs);
+    std::vector<long> cyclesMs(entries);
+    std::multimap<long, std::size_t> reference;
+    for (std::size_t i = 0; i < entries; i++) {
+        cyclesMs[i] = 1000 * cycleDistribution(random) + static_cast<long>(i % 7);
+        long deadlineMs = startMs + static_cast<long>(i * 13 % 60000);
+        wheel.schedule(i, deadlineMs);
+        reference.emplace(deadlineMs, i);
+    }
+    long nowMs = startMs;
+    std::size_t expirations = 0;
+    std::vector<TimingWheel::Expired> expired;
+    while (nowMs < startMs + 2 * 3600000) {
+        nowMs += stepDistribution(random);
+        // Never later than the next actual expiry
+        long nextMs = wheel.getNextDeadlineMs();
+        ASSERT_GE(nextMs, wheel.getCurrentMs());
+        ASSERT_LE(nextMs, std::max(reference.begin()->first, wheel.getCurrentMs()));
+        expired.clear();
+        wheel.advance(nowMs, expired);
+        std::multimap<long, std::size_t> expected(reference.begin(), reference.upper_bound(nowMs));
+        ASSERT_EQ(expired.size(), expected.size()) << "At " << nowMs;
+        for (const auto& entry : expired) {
+            auto range = expected.equal_range(entry.deadlineMs);
+            auto found = std::find_if(range.first, range.second, [&entry](const std::pair<const long, std::size_t>& item) {
+                return item.second == entry.id;
+            });
+            ASSERT_NE(found, range.second) << "Unexpected expiry of " << entry.id << " at " << nowMs;
+            expected.erase(found);
+            wheel.schedule(entry.id, entry.deadlineMs + cyclesMs[entry.id]);
+        }
+        reference.erase(reference.begin(), reference.upper_bound(nowMs));
+        for (const auto& entry : expired) {
+            reference.emplace(entry.deadlineMs + cyclesMs[entry.id], entry.id);
+        }
+        expirations += expired.size();
+        ASSERT_EQ(wheel.size(), entries);
+    }
+    ASSERT_GT(expirations, entries);
+}
@@ -0,0 +1,93 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <rapidjson/document.h>
+
+#include "traceRecorder.h"
+
+using namespace systemspn;
+
+class TestTraceRecorder : public testing::Test
+{
+protected:
+    const std::string traceFile = "test_traceRecorder.json";
+
+    void TearDown() override
+    {
+        TraceRecorder::getInstance().disable();
+        std::remove(traceFile.c_str());
+    }
+
+    bool parseTraceFile(rapidjson::Document& document)
+    {
+        std::ifstream file(traceFile);
+        std::stringstream content;
+        content << file.rdbuf();
+        return !document.Parse(content.str().c_str()).HasParseError() &&
+               document.HasMember("traceEvents") && document["traceEvents"].IsArray();
+    }
+};
+
+TEST_F(TestTraceRecorder, DisabledRecordsNothing)
+{
+    TraceRecorder& traceRecorder = TraceRecorder::getInstance();
+    traceRecorder.enable(16);
+    traceRecorder.disable();
+    ASSERT_FALSE(traceRecorder.isEnabled());
+    {
+        TraceRecorder::Span span("disabled");
+    }
+    traceRecorder.record("disabled", TraceRecorder::nowUs(), 1);
+    ASSERT_EQ(traceRecorder.getRecordedCount(), 0);
+}
+
+TEST_F(TestTraceRecorder, RingKeepsMostRecentSpans)
+{
+    TraceRecorder& traceRecorder = TraceRecorder::getInstance();
+    traceRecorder.enable(4);
+    ASSERT_TRUE(traceRecorder.isEnabled());
+    for (uint64_t i = 1; i <= 10; i++) {
+        traceRecorder.record("span", i * 100, i);
+    }
+    ASSERT_EQ(traceRecorder.getRecordedCount(), 4);
+
+    ASSERT_TRUE(traceRecorder.dump(traceFile));
+    rapidjson::Document document;
+    ASSERT_TRUE(parseTraceFile(document));
+    const rapidjson::Value& events = document["traceEvents"];
+    ASSERT_EQ(events.Size(), 4);
+    for (rapidjson::SizeType i = 0; i < events.Size(); i++) {
+        ASSERT_STREQ(events[i]["name"].GetString(), "span");
+        ASSERT_STREQ(events[i]["ph"].GetString(), "X");
+        ASSERT_EQ(events[i]["ts"].GetInt64(), static_cast<int64_t>((i + 7) * 100));
+        ASSERT_EQ(events[i]["dur"].GetInt64(), static_cast<int64_t>(i + 7));
+    }
+}
+
+TEST_F(TestTraceRecorder, ConcurrentSpans)
+{
+    TraceRecorder& traceRecorder = TraceRecorder::getInstance();
+    traceRecorder.enable(1024);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 1000; i++) {
+                TraceRecorder::Span span("concurrent");
+            }
+        });
+    }
+    // Dumping while spans are recorded must only write complete events
+    ASSERT_TRUE(traceRecorder.dump(traceFile));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(traceRecorder.getRecordedCount(), 1024);
+    ASSERT_TRUE(traceRecorder.dump(traceFile));
+    rapidjson::Document document;
+    ASSERT_TRUE(parseTraceFile(document));
+    ASSERT_EQ(document["traceEvents"].Size(), 1024);
+}
@@ -1,5 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <random>
 #include <thread>
 
 #include "utilityPivot.h"
@@ -20,6 +24,52 @@ TEST(TestUtilityPivot, convertTimestamp)
     }
 }
 
+TEST(TestUtilityPivot, FractionTableRoundTrip)
+{
+    for (long ms = -999; ms <= 999; ms++) {
+        long fraction = UtilityPivot::msToFraction(ms);
+        // Same value as the arithmetic conversion the table replaces
+        ASSERT_EQ(fraction, ms * 16777 + ((ms * 216) / 1000)) << ms;
+        ASSERT_EQ(UtilityPivot::fractionToMs(fraction), ms) << ms;
+        ASSERT_EQ(UtilityPivot::toTimestamp(1700000000L, fraction), 1700000000000L + ms);
+    }
+    ASSERT_EQ(UtilityPivot::fromTimestamp(1700000000999L), std::make_pair(1700000000L, 16760438L));
+}
+
+TEST(TestUtilityPivot, FractionToMsMatchesRounding)
+{
+    // Every fraction of a second received in a timestamp converts as with floating point rounding
+    for (long fraction = 0; fraction < (1L << 24); fraction++) {
+        long expected = static_cast<long>(round(static_cast<double>(fraction * 1000) / 16777216.0));
+        ASSERT_EQ(UtilityPivot::fractionToMs(fraction), expected) << fraction;
+        ASSERT_EQ(UtilityPivot::fractionToMs(-fraction), -expected) << fraction;
+    }
+}
+
+TEST(TestUtilityPivot, FormatInteger)
+{
+    char buffer[UtilityPivot::IntegerBufferSize];
+    auto format = [&buffer](long value) {
+        return std::string(buffer, UtilityPivot::formatInteger(value, buffer));
+    };
+    std::vector<long> values = {0, LONG_MIN, LONG_MAX, LONG_MIN + 1};
+    for (long power = 1; power <= LONG_MAX / 10; power *= 10) {
+        for (long value : {power - 1, power, power + 1, 10 * power - 1}) {
+            values.push_back(value);
+            values.push_back(-value);
+        }
+    }
+    std::mt19937_64 random(42);
+    for (int i = 0; i < 10000; i++) {
+        long value = static_cast<long>(random());
+        values.push_back(value);
+        values.push_back(value >> (i % 64));
+    }
+    for (long value : values) {
+        ASSERT_EQ(format(value), std::to_string(value));
+    }
+}
+
 TEST(TestUtilityPivot, getTimestamp) 
 {
     long t1 = UtilityPivot::getCurrentTimestampMs() / 1000L;
@@ -58,6 +108,29 @@ TEST(TestUtilityPivot, Split)
     ASSERT_EQ(UtilityPivot::split("TEST--TORTOISE", '-'), out2);
 }
 
+TEST(TestUtilityPivot, DataDirectory)
+{
+    const char *fledgeData = getenv("FLEDGE_DATA");
+    const char *fledgeRoot = getenv("FLEDGE_ROOT");
+    const std::string savedData = fledgeData ? fledgeData : "";
+    const std::string savedRoot = fledgeRoot ? fledgeRoot : "";
+
+    setenv("FLEDGE_DATA", "/var/fledge/data", 1);
+    setenv("FLEDGE_ROOT", "/usr/local/fledge", 1);
+    ASSERT_EQ(UtilityPivot::getDataDirectory(), "/var/fledge/data");
+    unsetenv("FLEDGE_DATA");
+    ASSERT_EQ(UtilityPivot::getDataDirectory(), "/usr/local/fledge/data");
+    unsetenv("FLEDGE_ROOT");
+    ASSERT_EQ(UtilityPivot::getDataDirectory(), "");
+
+    if (fledgeData) {
+        setenv("FLEDGE_DATA", savedData.c_str(), 1);
+    }
+    if (fledgeRoot) {
+        setenv("FLEDGE_ROOT", savedRoot.c_str(), 1);
+    }
+}
+
 TEST(TestUtilityPivot, Logs)
 {
     std::string text("This message is at level %s");
@@ -66,4 +139,31 @@ TEST(TestUtilityPivot, Logs)
     ASSERT_NO_THROW(UtilityPivot::log_warn(text.c_str(), "warning"));
     ASSERT_NO_THROW(UtilityPivot::log_error(text.c_str(), "error"));
     ASSERT_NO_THROW(UtilityPivot::log_fatal(text.c_str(), "fatal"));
-}
\ No newline at end of file
+}
+
+TEST(TestUtilityPivot, LogLevelEnabled)
+{
+    std::string previousLevel = Logger::getLogger()->getMinLevel();
+    using LogLevel = UtilityPivot::LogLevel;
+    const std::vector<LogLevel> levels = {LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error, LogLevel::Fatal};
+    // Fledge minimum level names, and the lowest level of message logged with each of them
+    const std::vector<std::pair<std::string, LogLevel>> minLevels = {
+        {"debug", LogLevel::Debug},
+        {"info", LogLevel::Info},
+        {"warning", LogLevel::Warning},
+        {"error", LogLevel::Error},
+        {"critical", LogLevel::Fatal},
+        // Unknown names fall back to the Fledge default level
+        {"", LogLevel::Warning},
+        {"fatal", LogLevel::Warning},
+    };
+    for (const auto& minLevel : minLevels) {
+        Logger::getLogger()->setMinLevel(minLevel.first);
+        for (LogLevel level : levels) {
+            ASSERT_EQ(UtilityPivot::isLogLevelEnabled(level), level >= minLevel.second)
+                << "Min level '" << minLevel.first << "', level " << static_cast<int>(level);
+        }
+    }
+
+    Logger::getLogger()->setMinLevel(previousLevel);
+}
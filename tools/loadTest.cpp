@@ -0,0 +1,199 @@
+/*
+ * Load test of the cyclic and prt.inf emissions with a counting ingest sink
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <config_category.h>
+#include <logger.h>
+#include <plugin_api.h>
+
+#include "notifySystemSp.h"
+#include "syntheticConfig.h"
+#include "toolUtils.h"
+
+using namespace systemspn;
+
+extern "C" {
+    PLUGIN_INFORMATION *plugin_info();
+    PLUGIN_HANDLE plugin_init(ConfigCategory *config);
+    void plugin_reconfigure(PLUGIN_HANDLE *handle, const std::string& newConfig);
+    bool plugin_deliver(PLUGIN_HANDLE handle, const std::string& deliveryName, const std::string& notificationName,
+                        const std::string& triggerReason, const std::string& message);
+    void plugin_registerIngest(PLUGIN_HANDLE *handle, void *func, void *data);
+    void plugin_shutdown(PLUGIN_HANDLE *handle);
+};
+
+namespace {
+    struct Options {
+        int         cyclicPoints = 1000;
+        int         prtInfPoints = 100;
+        long        cycleMs = 1000;
+        int         durationSec = 10;
+        long        giPeriodMs = 0;
+        int         shards = 1;
+        bool        affinity = false;
+        std::string output;
+    };
+
+    std::atomic<uint64_t> ingestedReadings{0};
+
+    void countingIngest(void */*data*/, void */*readingPtr*/) {
+        ingestedReadings.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void usage(const char *program) {
+        fprintf(stderr, "Usage: %s [--cyclic N] [--prtinf M] [--cycle SEC | --cycle-ms MS] [--duration SEC] [--gi-period MS]\n"
+                        "          [--shards N] [--affinity 0|1] [--output FILE]\n"
+                        "  --cyclic     Number of cyclic status points (default 1000)\n"
+                        "  --prtinf     Number of prt.inf status points (default 100)\n"
+                        "  --cycle      Emission cycle of the cyclic status points in seconds (default 1)\n"
+                        "  --cycle-ms   Emission cycle of the cyclic status points in milliseconds\n"
+                        "  --duration   Duration of the measure in seconds (default 10)\n"
+                        "  --gi-period  Period of 'gi_status' finished notifications in ms, 0 for none (default 0)\n"
+                        "  --shards     Number of scheduler shards emitting the cyclic status points (default 1)\n"
+                        "  --affinity   Bind each scheduler shard to its own CPU (default 0)\n"
+                        "  --output     File where the JSON results are written (default stdout)\n", program);
+    }
+
+    bool parseOptions(int argc, char **argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string name = argv[i];
+            if (i + 1 >= argc) {
+                return false;
+            }
+            const char *value = argv[++i];
+            if (name == "--cyclic") {
+                options.cyclicPoints = atoi(value);
+            }
+            else if (name == "--prtinf") {
+                options.prtInfPoints = atoi(value);
+            }
+            else if (name == "--cycle") {
+                options.cycleMs = 1000L * atol(value);
+            }
+            else if (name == "--cycle-ms") {
+                options.cycleMs = atol(value);
+            }
+            else if (name == "--duration") {
+                options.durationSec = atoi(value);
+            }
+            else if (name == "--gi-period") {
+                options.giPeriodMs = atol(value);
+            }
+            else if (name == "--shards") {
+                options.shards = atoi(value);
+            }
+            else if (name == "--affinity") {
+                options.affinity = atoi(value) != 0;
+            }
+            else if (name == "--output") {
+                options.output = value;
+            }
+            else {
+                return false;
+            }
+        }
+        return (options.cyclicPoints >= 0) && (options.prtInfPoints >= 0) && (options.cycleMs > 0) &&
+               (options.durationSec > 0) && (options.giPeriodMs >= 0) && (options.shards > 0);
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    Logger::getLogger()->setMinLevel("warning");
+
+    PLUGIN_INFORMATION *info = plugin_info();
+    ConfigCategory config("systemspn_loadtest", info->config);
+    config.setItemsValueFromDefault();
+    config.setValue("enable", "false");
+    config.setValue("scheduler_shards", std::to_string(options.shards));
+    config.setValue("scheduler_cpu_affinity", options.affinity ? "true" : "false");
+    PLUGIN_HANDLE handle = plugin_init(&config);
+    auto plugin = static_cast<NotifySystemSp*>(handle);
+    plugin_registerIngest(reinterpret_cast<PLUGIN_HANDLE*>(handle), reinterpret_cast<void*>(countingIngest), nullptr);
+
+    // Cycle threads are started with the configuration, the measure starts with the first emissions
+    ToolUtils::ResourceUsage startUsage = ToolUtils::getResourceUsage();
+    auto setupStart = std::chrono::steady_clock::now();
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(handle), SyntheticConfig::buildPluginConfig(
+                       SyntheticConfig::buildExchangedData(options.cyclicPoints, options.prtInfPoints, 0, options.cycleMs)));
+    double setupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+
+    const std::string giFinished = R"({"asset":"gi_status","reason":"finished"})";
+    uint64_t giNotifications = 0;
+    uint64_t readingsAtStart = ingestedReadings;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(options.durationSec);
+    auto nextGi = start;
+    while (std::chrono::steady_clock::now() < end) {
+        if ((options.giPeriodMs > 0) && (std::chrono::steady_clock::now() >= nextGi)) {
+            plugin_deliver(handle, "loadtest", "loadtest", giFinished, "");
+            giNotifications++;
+            nextGi += std::chrono::milliseconds(options.giPeriodMs);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.giPeriodMs > 0 ? std::min(options.giPeriodMs, 100L) : 100));
+    }
+    double elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t readings = ingestedReadings - readingsAtStart;
+    ToolUtils::ResourceUsage endUsage = ToolUtils::getResourceUsage();
+    ToolUtils::ProcessStatus status = ToolUtils::getProcessStatus();
+
+    PerfMetrics::Snapshot metrics = plugin->getMetrics();
+    uint64_t emissions = 0;
+    uint64_t lateEmissions = 0;
+    uint64_t jitterP50Ms = 0;
+    uint64_t jitterP99Ms = 0;
+    uint64_t jitterMaxMs = 0;
+    for (const auto& kvp : plugin->getAllCycleStats()) {
+        emissions += kvp.second.emissions;
+        lateEmissions += kvp.second.lateEmissions;
+        jitterP50Ms = std::max(jitterP50Ms, kvp.second.p50Ms);
+        jitterP99Ms = std::max(jitterP99Ms, kvp.second.p99Ms);
+        jitterMaxMs = std::max(jitterMaxMs, kvp.second.maxMs);
+    }
+
+    std::string json = "{";
+    json += "\"cyclic_points\":" + std::to_string(options.cyclicPoints);
+    json += ",\"prtinf_points\":" + std::to_string(options.prtInfPoints);
+    json += ",\"cycle_ms\":" + std::to_string(options.cycleMs);
+    json += ",\"shards\":" + std::to_string(options.shards);
+    json += ",\"duration_sec\":" + std::to_string(elapsedSec);
+    json += ",\"setup_ms\":" + std::to_string(setupMs);
+    json += ",\"readings\":" + std::to_string(readings);
+    json += ",\"readings_per_sec\":" + std::to_string(readings / elapsedSec);
+    json += ",\"expected_cyclic_per_sec\":" + std::to_string(1000.0 * options.cyclicPoints / options.cycleMs);
+    json += ",\"gi_notifications\":" + std::to_string(giNotifications);
+    json += ",\"prtinf_readings\":" + std::to_string(metrics.counter(PerfMetrics::Counter::ReadingsPrtInf));
+    json += ",\"dropped_readings\":" + std::to_string(metrics.counter(PerfMetrics::Counter::ReadingsDropped));
+    json += ",\"deadline_emissions\":" + std::to_string(emissions);
+    json += ",\"late_emissions\":" + std::to_string(lateEmissions);
+    json += ",\"jitter_p50_ms\":" + std::to_string(jitterP50Ms);
+    json += ",\"jitter_p99_ms\":" + std::to_string(jitterP99Ms);
+    json += ",\"jitter_max_ms\":" + std::to_string(jitterMaxMs);
+    json += ",\"ingest_p99_us\":" + std::to_string(metrics.latencyNs(PerfMetrics::Latency::IngestCallback).percentile(99) / 1000);
+    json += ",\"cpu_user_sec\":" + std::to_string(endUsage.userSec - startUsage.userSec);
+    json += ",\"cpu_system_sec\":" + std::to_string(endUsage.systemSec - startUsage.systemSec);
+    json += ",\"cpu_percent\":" + std::to_string(100.0 * (endUsage.userSec + endUsage.systemSec -
+                                                          startUsage.userSec - startUsage.systemSec) / elapsedSec);
+    json += ",\"rss_kb\":" + std::to_string(status.rssKb);
+    json += ",\"rss_peak_kb\":" + std::to_string(status.rssPeakKb);
+    json += ",\"threads\":" + std::to_string(status.threads);
+    json += "}\n";
+
+    plugin_shutdown(reinterpret_cast<PLUGIN_HANDLE*>(handle));
+    return ToolUtils::writeOutput(options.output, json) ? 0 : 1;
+}
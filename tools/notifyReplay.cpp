@@ -0,0 +1,232 @@
+/*
+ * Replay of recorded notifications through plugin_deliver
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <config_category.h>
+#include <logger.h>
+#include <plugin_api.h>
+#include <rapidjson/document.h>
+
+#include "notifySystemSp.h"
+#include "perfMetrics.h"
+#include "syntheticConfig.h"
+#include "toolUtils.h"
+
+using namespace systemspn;
+
+extern "C" {
+    PLUGIN_INFORMATION *plugin_info();
+    PLUGIN_HANDLE plugin_init(ConfigCategory *config);
+    void plugin_reconfigure(PLUGIN_HANDLE *handle, const std::string& newConfig);
+    bool plugin_deliver(PLUGIN_HANDLE handle, const std::string& deliveryName, const std::string& notificationName,
+                        const std::string& triggerReason, const std::string& message);
+    void plugin_registerIngest(PLUGIN_HANDLE *handle, void *func, void *data);
+    void plugin_shutdown(PLUGIN_HANDLE *handle);
+};
+
+namespace {
+    struct Options {
+        std::string input;
+        std::string config;
+        int         prtInfPoints = 100;
+        double      rate = 0;
+        int         repeat = 1;
+        std::string output;
+    };
+
+    struct Notification {
+        std::string notificationName;
+        std::string triggerReason;
+        std::string message;
+    };
+
+    std::atomic<uint64_t> ingestedReadings{0};
+
+    void countingIngest(void */*data*/, void */*readingPtr*/) {
+        ingestedReadings.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void usage(const char *program) {
+        fprintf(stderr, "Usage: %s --input FILE [--config FILE] [--prtinf M] [--rate N] [--repeat K] [--output FILE]\n"
+                        "  --input   Recorded notifications, one JSON object per line:\n"
+                        "            {\"notificationName\": \"...\", \"triggerReason\": \"{...}\", \"message\": \"...\"}\n"
+                        "  --config  Plugin configuration as given to plugin_reconfigure (default: M synthetic prt.inf points)\n"
+                        "  --prtinf  Number of synthetic prt.inf status points when no configuration is given (default 100)\n"
+                        "  --rate    Notifications per second, 0 for as fast as possible (default 0)\n"
+                        "  --repeat  Number of times the input is replayed (default 1)\n"
+                        "  --output  File where the JSON results are written (default stdout)\n", program);
+    }
+
+    bool parseOptions(int argc, char **argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string name = argv[i];
+            if (i + 1 >= argc) {
+                return false;
+            }
+            const char *value = argv[++i];
+            if (name == "--input") {
+                options.input = value;
+            }
+            else if (name == "--config") {
+                options.config = value;
+            }
+            else if (name == "--prtinf") {
+                options.prtInfPoints = atoi(value);
+            }
+            else if (name == "--rate") {
+                options.rate = atof(value);
+            }
+            else if (name == "--repeat") {
+                options.repeat = atoi(value);
+            }
+            else if (name == "--output") {
+                options.output = value;
+            }
+            else {
+                return false;
+            }
+        }
+        return !options.input.empty() && (options.prtInfPoints >= 0) && (options.rate >= 0) && (options.repeat > 0);
+    }
+
+    bool readFile(const std::string& filePath, std::string& content) {
+        std::ifstream file(filePath);
+        if (!file) {
+            fprintf(stderr, "Unable to read '%s'\n", filePath.c_str());
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        content = buffer.str();
+        return true;
+    }
+
+    bool readNotifications(const std::string& filePath, std::vector<Notification>& notifications) {
+        std::string content;
+        if (!readFile(filePath, content)) {
+            return false;
+        }
+        std::istringstream lines(content);
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(lines, line)) {
+            lineNumber++;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            rapidjson::Document document;
+            if (document.Parse(line.c_str()).HasParseError() || !document.IsObject() ||
+                !document.HasMember("triggerReason") || !document["triggerReason"].IsString()) {
+                fprintf(stderr, "%s:%d: invalid notification, a JSON object with a 'triggerReason' string is expected\n",
+                        filePath.c_str(), lineNumber);
+                return false;
+            }
+            Notification notification;
+            notification.triggerReason = document["triggerReason"].GetString();
+            if (document.HasMember("notificationName") && document["notificationName"].IsString()) {
+                notification.notificationName = document["notificationName"].GetString();
+            }
+            if (document.HasMember("message") && document["message"].IsString()) {
+                notification.message = document["message"].GetString();
+            }
+            notifications.push_back(notification);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    std::vector<Notification> notifications;
+    if (!readNotifications(options.input, notifications)) {
+        return 1;
+    }
+    std::string pluginConfig;
+    if (options.config.empty()) {
+        pluginConfig = SyntheticConfig::buildPluginConfig(SyntheticConfig::buildExchangedData(0, options.prtInfPoints));
+    }
+    else if (!readFile(options.config, pluginConfig)) {
+        return 1;
+    }
+    Logger::getLogger()->setMinLevel("warning");
+
+    PLUGIN_INFORMATION *info = plugin_info();
+    ConfigCategory config("systemspn_replay", info->config);
+    config.setItemsValueFromDefault();
+    PLUGIN_HANDLE handle = plugin_init(&config);
+    auto plugin = static_cast<NotifySystemSp*>(handle);
+    plugin_registerIngest(reinterpret_cast<PLUGIN_HANDLE*>(handle), reinterpret_cast<void*>(countingIngest), nullptr);
+    plugin_reconfigure(reinterpret_cast<PLUGIN_HANDLE*>(handle), pluginConfig);
+
+    // Readings of cyclic status points are not caused by the notifications
+    PerfMetrics::Snapshot before = plugin->getMetrics();
+    LatencyHistogram latencies;
+    uint64_t accepted = 0;
+    uint64_t sent = 0;
+    ToolUtils::ResourceUsage startUsage = ToolUtils::getResourceUsage();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < options.repeat; r++) {
+        for (const auto& notification : notifications) {
+            if (options.rate > 0) {
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                      std::chrono::duration<double>(sent / options.rate)));
+            }
+            auto callStart = std::chrono::steady_clock::now();
+            if (plugin_deliver(handle, "replay", notification.notificationName, notification.triggerReason,
+                               notification.message)) {
+                accepted++;
+            }
+            latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - callStart).count());
+            sent++;
+        }
+    }
+    double elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ToolUtils::ResourceUsage endUsage = ToolUtils::getResourceUsage();
+    PerfMetrics::Snapshot after = plugin->getMetrics();
+
+    HistogramSnapshot latenciesNs;
+    latenciesNs.merge(latencies);
+    uint64_t prtInfReadings = after.counter(PerfMetrics::Counter::ReadingsPrtInf) -
+                              before.counter(PerfMetrics::Counter::ReadingsPrtInf);
+    std::string json = "{";
+    json += "\"notifications\":" + std::to_string(sent);
+    json += ",\"accepted\":" + std::to_string(accepted);
+    json += ",\"rejected\":" + std::to_string(sent - accepted);
+    json += ",\"gi_triggers_merged\":" + std::to_string(plugin->getGiTriggersMerged());
+    json += ",\"duration_sec\":" + std::to_string(elapsedSec);
+    json += ",\"target_rate\":" + std::to_string(options.rate);
+    json += ",\"notifications_per_sec\":" + std::to_string(sent / elapsedSec);
+    json += ",\"latency_mean_us\":" + std::to_string(latenciesNs.mean() / 1e3);
+    json += ",\"latency_p50_us\":" + std::to_string(latenciesNs.percentile(50) / 1e3);
+    json += ",\"latency_p90_us\":" + std::to_string(latenciesNs.percentile(90) / 1e3);
+    json += ",\"latency_p99_us\":" + std::to_string(latenciesNs.percentile(99) / 1e3);
+    json += ",\"latency_p999_us\":" + std::to_string(latenciesNs.percentile(99.9) / 1e3);
+    json += ",\"latency_max_us\":" + std::to_string(latenciesNs.max / 1e3);
+    json += ",\"prtinf_readings\":" + std::to_string(prtInfReadings);
+    json += ",\"ingested_readings\":" + std::to_string(ingestedReadings.load());
+    json += ",\"readings_per_notification\":" + std::to_string(sent > 0 ? static_cast<double>(prtInfReadings) / sent : 0);
+    json += ",\"cpu_user_sec\":" + std::to_string(endUsage.userSec - startUsage.userSec);
+    json += ",\"cpu_system_sec\":" + std::to_string(endUsage.systemSec - startUsage.systemSec);
+    json += "}\n";
+
+    plugin_shutdown(reinterpret_cast<PLUGIN_HANDLE*>(handle));
+    return ToolUtils::writeOutput(options.output, json) ? 0 : 1;
+}
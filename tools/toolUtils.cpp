@@ -0,0 +1,73 @@
+/*
+ * Process measures shared by the load and replay tools
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sys/resource.h>
+
+#include "toolUtils.h"
+
+/**
+ * Get the CPU time consumed by the process so far
+ *
+ * @return User and system CPU time in seconds
+*/
+ToolUtils::ResourceUsage ToolUtils::getResourceUsage() {
+    ResourceUsage usage;
+    struct rusage rusage;
+    if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+        usage.userSec = rusage.ru_utime.tv_sec + rusage.ru_utime.tv_usec / 1e6;
+        usage.systemSec = rusage.ru_stime.tv_sec + rusage.ru_stime.tv_usec / 1e6;
+    }
+    return usage;
+}
+
+/**
+ * Get the memory and thread count of the process from /proc/self/status
+ *
+ * @return Current and peak resident set size, and number of threads
+*/
+ToolUtils::ProcessStatus ToolUtils::getProcessStatus() {
+    ProcessStatus status;
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            status.rssKb = atol(line.c_str() + 6);
+        }
+        else if (line.compare(0, 6, "VmHWM:") == 0) {
+            status.rssPeakKb = atol(line.c_str() + 6);
+        }
+        else if (line.compare(0, 8, "Threads:") == 0) {
+            status.threads = atol(line.c_str() + 8);
+        }
+    }
+    return status;
+}
+
+/**
+ * Write results to a file, or to stdout
+ *
+ * @param filePath : File to write, stdout if empty
+ * @param content : Content to write
+ * @return True if the content was written, else false
+*/
+bool ToolUtils::writeOutput(const std::string& filePath, const std::string& content) {
+    if (filePath.empty()) {
+        fputs(content.c_str(), stdout);
+        return fflush(stdout) == 0;
+    }
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+    file << content;
+    if (!file) {
+        fprintf(stderr, "Unable to write '%s'\n", filePath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef TOOLS_TOOL_UTILS_H_
+#define TOOLS_TOOL_UTILS_H_
+
+/*
+ * Process measures shared by the load and replay tools
+ *
+ * Copyright (c) 2020, RTE (https://www.rte-france.com)
+ *
+ * Released under the Apache 2.0 Licence
+ *
+ */
+#include <string>
+
+namespace ToolUtils {
+    struct ResourceUsage {
+        double userSec = 0;
+        double systemSec = 0;
+    };
+    struct ProcessStatus {
+        long rssKb = 0;
+        long rssPeakKb = 0;
+        long threads = 0;
+    };
+
+    ResourceUsage getResourceUsage();
+    ProcessStatus getProcessStatus();
+    bool          writeOutput(const std::string& filePath, const std::string& content);
+};
+
+#endif  // TOOLS_TOOL_UTILS_H_